@@ -0,0 +1,47 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;       // 顶点位置属性
+layout (location = 1) in vec2 aTexCoord;  // 纹理坐标属性
+layout (location = 2) in vec3 aNormal;    // 法线属性
+layout (location = 3) in uint aDrawIndex; // record in BatchDraws (per instance, offset by baseInstance)
+
+out vec2 TexCoord;
+out vec3 Normal;    // 世界空间
+out vec3 FragPos;   // 世界空间
+flat out vec3 BaseColor;
+flat out vec3 Emissive;
+
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 cameraPos;
+};
+
+// Mirrors BatchDrawData in meshbatch.h; 64 = MAX_BATCH_DRAWS
+struct DrawData {
+    mat4 model;
+    mat4 normalMatrix;
+    vec4 baseColor;
+    vec4 emissive;
+    vec4 positionOffset;
+    vec4 positionScale;
+};
+
+layout(std140) uniform BatchDraws {
+    DrawData draws[64];
+};
+
+void main()
+{
+    DrawData draw = draws[aDrawIndex];
+    vec3 position = draw.positionOffset.xyz + aPos * draw.positionScale.xyz;
+    vec4 worldPos = draw.model * vec4(position, 1.0);
+
+    gl_Position = projection * view * worldPos;
+    TexCoord = aTexCoord;
+    Normal = mat3(draw.normalMatrix) * aNormal;
+    FragPos = vec3(worldPos);
+    BaseColor = draw.baseColor.rgb;
+    Emissive = draw.emissive.rgb;
+}
@@ -0,0 +1,34 @@
+#version 330 core
+
+in vec2 TexCoord;
+in vec3 Normal;    // 世界空间
+in vec3 FragPos;   // 世界空间
+flat in vec3 PartColor; // livery or part colour
+
+out vec4 FragColor;
+
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 cameraPos;
+};
+
+uniform vec3 materialDiffuse;
+uniform vec3 materialEmissive;
+
+// Same lighting as carShader.frag
+void main()
+{
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos.xyz - FragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor.rgb;
+
+    float ambientStrength = 0.1;
+    vec3 ambient = ambientStrength * lightColor.rgb;
+
+    vec3 lighting = ambient + diffuse;
+    FragColor = vec4(lighting * PartColor * materialDiffuse + materialEmissive, 1.0);
+}
@@ -0,0 +1,63 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec3 aNormal;
+// Per instance (one car)
+layout (location = 4) in mat4 iModel;   // locations 4-7
+layout (location = 8) in vec3 iLivery;
+layout (location = 9) in vec2 iAngles;  // steering, wheel spin (radians)
+
+out vec2 TexCoord;
+out vec3 Normal;    // 世界空间
+out vec3 FragPos;   // 世界空间
+flat out vec3 PartColor;
+
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 cameraPos;
+};
+
+// Per part, see PartRig: xyz pivot, w = 1 if the part steers / spins
+uniform vec4 partSteerPivot;
+uniform vec4 partSpinPivot;
+uniform float partLivery; // 1 takes iLivery, 0 keeps objectColor
+uniform vec3 objectColor;
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+
+mat3 rotateY(float angle)
+{
+    float c = cos(angle), s = sin(angle);
+    return mat3(c, 0.0, -s,  0.0, 1.0, 0.0,  s, 0.0, c);
+}
+
+mat3 rotateZ(float angle)
+{
+    float c = cos(angle), s = sin(angle);
+    return mat3(c, s, 0.0,  -s, c, 0.0,  0.0, 0.0, 1.0);
+}
+
+void main()
+{
+    vec3 position = positionOffset + aPos * positionScale;
+    vec3 normal = aNormal;
+
+    // Spin first, then steer: model = car * steer * spin
+    mat3 spin = rotateZ(iAngles.y * partSpinPivot.w);
+    position = partSpinPivot.xyz + spin * (position - partSpinPivot.xyz);
+    normal = spin * normal;
+    mat3 steer = rotateY(iAngles.x * partSteerPivot.w);
+    position = partSteerPivot.xyz + steer * (position - partSteerPivot.xyz);
+    normal = steer * normal;
+
+    vec4 worldPos = iModel * vec4(position, 1.0);
+    gl_Position = projection * view * worldPos;
+    TexCoord = aTexCoord;
+    // Car transforms are rigid (uniform scale at most), so no inverse transpose is needed
+    Normal = mat3(iModel) * normal;
+    FragPos = vec3(worldPos);
+    PartColor = mix(objectColor, iLivery, partLivery);
+}
@@ -9,25 +9,34 @@ out vec4 FragColor; // 片段的最终颜色输出
 
 // 其他可能需要的uniforms，例如光源位置、材质属性、纹理采样器等
 uniform vec3 objectColor;
-uniform vec3 lightColor;
-uniform vec3 lightPos;
+// Material from the .mtl file (Kd, Ke); the default material is white with no emission
+uniform vec3 materialDiffuse;
+uniform vec3 materialEmissive;
+
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 cameraPos;
+};
 // uniform sampler2D ourTexture; // 如果有纹理
 
 void main()
 {
     // 示例：简单的漫反射光照
     vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 lightDir = normalize(lightPos.xyz - FragPos);
     float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diff * lightColor;
+    vec3 diffuse = diff * lightColor.rgb;
 
     // 示例：环境光
     float ambientStrength = 0.1;
-    vec3 ambient = ambientStrength * lightColor;
+    vec3 ambient = ambientStrength * lightColor.rgb;
 
     // 最终颜色 = 环境光 + 漫反射 (这里没有包含镜面光和纹理，你可以根据需要添加)
     // 如果有纹理，可能是 FragColor = vec4(ambient + diffuse, 1.0) * texture(ourTexture, TexCoord);
     vec3 lighting = ambient + diffuse;
-    vec3 result = lighting * objectColor;
+    vec3 result = lighting * objectColor * materialDiffuse + materialEmissive;
     FragColor = vec4(result, 1.0); 
 }
\ No newline at end of file
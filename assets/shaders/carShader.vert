@@ -7,14 +7,27 @@ out vec2 TexCoord;  // 传递给片段着色器的纹理坐标
 out vec3 Normal;    // 传递给片段着色器的法线（世界空间）
 out vec3 FragPos;   // 传递给片段着色器的片段位置（世界空间）
 
+// Per-frame camera and light data, shared by every program (binding point FRAME_DATA_BINDING)
+layout(std140) uniform FrameData {
+    mat4 view;        // 视图矩阵
+    mat4 projection;  // 投影矩阵
+    vec4 lightPos;
+    vec4 lightColor;
+    vec4 cameraPos;
+};
+
 uniform mat4 model;       // 模型矩阵
-uniform mat4 view;        // 视图矩阵
-uniform mat4 projection;  // 投影矩阵
+// Packed meshes store positions as unorm16 across their bounds: pos = offset + aPos * scale.
+// Float meshes pass offset 0 and scale 1.
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
 
 void main()
 {
+    vec3 position = positionOffset + aPos * positionScale;
+
     // 计算顶点在裁剪空间中的最终位置
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * model * vec4(position, 1.0);
     
     // 将纹理坐标直接传递给片段着色器（它会被插值）
     TexCoord = aTexCoord;
@@ -23,5 +36,5 @@ void main()
     Normal = mat3(transpose(inverse(model))) * aNormal;
     
     // 计算片段的世界空间位置
-    FragPos = vec3(model * vec4(aPos, 1.0));
+    FragPos = vec3(model * vec4(position, 1.0));
 }
\ No newline at end of file
@@ -1,9 +1,9 @@
 #version 330 core
 out vec4 FragColor;
 
-uniform vec3 objectColor;
+in vec4 vColor;
 
 void main()
 {
-    FragColor = vec4(objectColor, 1.0);
+    FragColor = vColor;
 }
\ No newline at end of file
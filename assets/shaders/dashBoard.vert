@@ -1,10 +1,14 @@
 #version 330 core
 layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec4 aColor;
 
 uniform mat4 model;
 uniform mat4 projection;
 
+out vec4 vColor;
+
 void main()
 {
+    vColor = aColor;
     gl_Position = projection * model * vec4(aPos.x, aPos.y, 0.0, 1.0);
 }
\ No newline at end of file
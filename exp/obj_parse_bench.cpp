@@ -0,0 +1,100 @@
+// Scaling benchmark for the chunked OBJ parser.
+// Usage: obj_parse_bench <file.obj> [maxThreads] [repeats]
+// Parses the file with 1..maxThreads threads, reports the best time of each and
+// checks that every run produces exactly the same mesh as the single-threaded one.
+// First checks meshes whose corners are all unique (flat-shaded, one vn per face),
+// which once filled the corner table completely and never returned.
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <thread>
+#include <algorithm>
+#include "objloader.h"
+#include "utils.h"
+
+template <typename T>
+bool sameBytes(const std::vector<T>& a, const std::vector<T>& b) {
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+bool sameMesh(const MeshData& a, const MeshData& b) {
+    return sameBytes(a.vertices, b.vertices) && sameBytes(a.uvs, b.uvs)
+        && sameBytes(a.normals, b.normals) && sameBytes(a.indices, b.indices);
+}
+
+// triangleCount triangles sharing nothing, so every corner becomes its own vertex
+std::string uniqueCornerOBJ(int triangleCount) {
+    std::string text;
+    for (int i = 0; i < triangleCount * 3; ++i) text += "v " + std::to_string(i) + " 0 0\n";
+    for (int i = 0; i < triangleCount; ++i) text += "vn 0 0 1\n";
+    for (int i = 0; i < triangleCount; ++i) {
+        text += "f";
+        for (int k = 1; k <= 3; ++k) text += " " + std::to_string(i * 3 + k) + "//" + std::to_string(i + 1);
+        text += "\n";
+    }
+    return text;
+}
+
+bool checkUniqueCorners() {
+    // 3 * T = 2^k + 1 corners was the failing case: 11 triangles are 33 corners
+    for (int triangles : { 10, 11, 43, 171, 683 }) {
+        std::string text = uniqueCornerOBJ(triangles);
+        MeshData mesh;
+        parseOBJText(text.data(), text.size(), mesh, 1);
+        if (mesh.vertices.size() != static_cast<size_t>(triangles) * 3) {
+            std::cerr << "Error: " << triangles << " triangles with unique corners gave "
+                      << mesh.vertices.size() << " vertices" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.obj> [maxThreads] [repeats]" << std::endl;
+        return 1;
+    }
+    unsigned int maxThreads = argc > 2 ? std::stoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+    int repeats = argc > 3 ? std::stoi(argv[3]) : 3;
+    if (!checkUniqueCorners()) {
+        return 3;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open OBJ file: " << argv[1] << std::endl;
+        return 1;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    double megabytes = text.size() / (1024.0 * 1024.0);
+
+    MeshData reference;
+    parseOBJText(text.data(), text.size(), reference, 1);
+    std::cout << argv[1] << ": " << std::fixed << std::setprecision(1) << megabytes << " MB, "
+              << reference.vertices.size() << " vertices, " << reference.indices.size() / 3 << " triangles" << std::endl;
+    std::cout << "threads      ms     MB/s  speedup  identical" << std::endl;
+
+    double baseline = 0.0;
+    bool allIdentical = true;
+    for (unsigned int threads = 1; threads <= maxThreads; ++threads) {
+        double best = 1e30;
+        bool identical = true;
+        for (int r = 0; r < repeats; ++r) {
+            MeshData mesh;
+            auto start = std::chrono::steady_clock::now();
+            parseOBJText(text.data(), text.size(), mesh, threads);
+            best = std::min(best, millisecondsSince(start));
+            identical = identical && sameMesh(mesh, reference);
+        }
+        if (threads == 1) baseline = best;
+        allIdentical = allIdentical && identical;
+        std::cout << std::setw(7) << threads << std::setw(8) << std::setprecision(1) << best
+                  << std::setw(9) << megabytes / (best / 1000.0)
+                  << std::setw(8) << std::setprecision(2) << baseline / best << "x"
+                  << std::setw(11) << (identical ? "yes" : "NO") << std::endl;
+    }
+    return allIdentical ? 0 : 2;
+}
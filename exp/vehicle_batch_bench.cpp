@@ -0,0 +1,102 @@
+// Throughput of the structure-of-arrays vehicle batch against stepping one
+// VehicleState at a time (the kinematic model SimThread runs with --kinematic).
+// Usage: vehicle_batch_bench [maxCars] [carStepsPerRun]
+// For 8..maxCars cars, runs both with the same scripted controls at 240 Hz and
+// reports car-steps per second, the speedup and how far the two end apart.
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "vehicle.h"
+#include "vehiclebatch.h"
+#include "utils.h"
+
+namespace {
+
+const float STEP = 1.0f / 240.0f;
+const int CONTROL_PERIOD = 120; // steps between control changes
+
+// Reproducible per-car inputs that change every CONTROL_PERIOD steps
+VehicleControls scriptedControls(size_t car, int step) {
+    uint32_t h = static_cast<uint32_t>(car) * 2654435761u ^ static_cast<uint32_t>(step / CONTROL_PERIOD) * 40503u;
+    h ^= h >> 13;
+    h *= 0x5bd1e995u;
+    h ^= h >> 15;
+    VehicleControls controls;
+    controls.throttle = (h & 3) != 0;
+    controls.brake = (h & 12) == 12;
+    controls.left = (h & 48) == 16;
+    controls.right = (h & 48) == 32;
+    return controls;
+}
+
+VehicleState startState(size_t car) {
+    VehicleState state;
+    state.position = glm::vec3(-8.0f * static_cast<float>(car / 2), 0.0f, car % 2 ? -2.5f : 2.5f);
+    return state;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t maxCars = argc > 1 ? std::stoul(argv[1]) : 32768;
+    double carSteps = argc > 2 ? std::stod(argv[2]) : 2e7;
+
+    VehicleParams params;
+    params.model = VehicleModel::Kinematic;
+    std::cout << "Kinematic model, " << (VehicleBatch::vectorized() ? "AVX2 kernel" : "scalar kernel (build with F1_AVX2)")
+              << ", " << 1.0f / STEP << " Hz" << std::endl;
+    std::cout << "   cars   steps  one-by-one Mcs/s  batch Mcs/s  speedup  max deviation (m)" << std::endl;
+
+    for (size_t cars = 8; cars <= maxCars; cars *= 8) {
+        int steps = std::max(1, static_cast<int>(carSteps / static_cast<double>(cars)));
+
+        std::vector<VehicleState> states(cars);
+        std::vector<VehicleControls> controls(cars);
+        for (size_t car = 0; car < cars; ++car) {
+            states[car] = startState(car);
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (int step = 0; step < steps; ++step) {
+            if (step % CONTROL_PERIOD == 0) {
+                for (size_t car = 0; car < cars; ++car) {
+                    controls[car] = scriptedControls(car, step);
+                }
+            }
+            for (size_t car = 0; car < cars; ++car) {
+                stepVehicle(states[car], controls[car], params, STEP);
+            }
+        }
+        double scalarMs = millisecondsSince(start);
+
+        VehicleBatch batch(params);
+        for (size_t car = 0; car < cars; ++car) {
+            batch.add(startState(car));
+        }
+        start = std::chrono::steady_clock::now();
+        for (int step = 0; step < steps; ++step) {
+            if (step % CONTROL_PERIOD == 0) {
+                for (size_t car = 0; car < cars; ++car) {
+                    batch.setControls(car, scriptedControls(car, step));
+                }
+            }
+            batch.step(STEP);
+        }
+        double batchMs = millisecondsSince(start);
+
+        float deviation = 0.0f;
+        for (size_t car = 0; car < cars; ++car) {
+            deviation = std::max(deviation, glm::length(batch.state(car).position - states[car].position));
+        }
+        double total = static_cast<double>(cars) * steps;
+        std::cout << std::setw(7) << cars << std::setw(8) << steps
+                  << std::fixed << std::setprecision(1) << std::setw(18) << total / scalarMs / 1000.0
+                  << std::setw(13) << total / batchMs / 1000.0
+                  << std::setprecision(2) << std::setw(8) << scalarMs / batchMs << "x"
+                  << std::scientific << std::setprecision(2) << std::setw(19) << deviation
+                  << std::defaultfloat << std::endl;
+    }
+    return 0;
+}
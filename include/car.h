@@ -9,16 +9,21 @@
 #include <wheel.h>
 #include <front.h>
 #include "audio.h"
-
-#define FRONTAXIS 2.7
+#include "mesh.h"
+#include "meshbatch.h"
+#include "carfleet.h"
+#include "vehicle.h"
 
 class Car {
 public:
     Car();
     ~Car();
 
-    void draw(Shader& carshader);
-    void update(float deltaTime);
+    // Draws every part with one batch; the carBatch shader must be in use
+    void draw(const RenderView& view);
+    // Poses the car and its wheels for drawing from a SimThread snapshot; SimThread
+    // is the only place the vehicle model (vehicle.h) and engine audio are stepped
+    void applyState(const VehicleState& newState);
  
     // Setters
     void setPosition(const glm::vec3& newPosition);
@@ -40,35 +45,33 @@ public:
     void setDeltaRight(bool);
 
     // Getters (const-correct for safety)
-    glm::vec3 getPosition() const { return position; }
-    glm::vec3 getVelocity() const { return velocity; }
-    glm::vec3 getAcceleration() const { return acceleration; }
+    glm::vec3 getPosition() const { return state.position; }
+    glm::vec3 getVelocity() const { return state.velocity; }
+    glm::vec3 getAcceleration() const { return state.acceleration; }
     glm::vec3 getColor() const { return color; }
     glm::mat4 getModelMatrix() const { return modelMatrix; }
-    float getDeltaTime() const {return deltaTime; }
+    const VehicleState& getState() const { return state; }
+    const VehicleControls& getControls() const { return controls; }
+    const VehicleParams& getParams() const { return params; }
+    CarAudio& getAudio() { return carAudio; }
 
     // Model loading and GPU buffer setup
     bool loadModel(); // Returns true on success
-    void setupGPUBuffers(); // Pushes loaded vertices/indices to GPU
+    void setupGPUBuffers(); // Packs all part meshes into the car's batch
+
+    // Part meshes in batch order and how each moves and is coloured, for CarFleet
+    std::vector<MeshHandle> partMeshes() const;
+    std::vector<PartRig> partRig() const;
+    // This car as a fleet instance (body colour as livery)
+    FleetCar fleetState() const;
 
 private:
-    glm::vec3 position;
-    glm::vec3 velocity;
-    glm::vec3 acceleration; // Added
+    VehicleState state;
+    VehicleControls controls; // Phase register
+    VehicleParams params;
     glm::vec3 color;        // Added
     glm::vec3 scale;        // Optional, added
     
-    // Phase register
-    bool throttleStatus;
-    bool breakStatus;
-    bool leftStatus;
-    bool rightStatus;
-    float angularVelocity;
-    float angle;
-    float breakTime;
-    float deltaAngle;
-    float deltaTime;
-    
     // Audio
     CarAudio carAudio;
 
@@ -77,21 +80,19 @@ private:
     Wheel rearLeft;
     Wheel rearRight;
 
-    // Model Data
-    std::vector<glm::vec3> vertices; 
-    std::vector<glm::vec2> uvs;
-    std::vector<glm::vec3> normals;
-    std::vector<unsigned int> indices;
+    // Shared mesh (parsed data, bounds and materials) from the MeshRegistry
+    MeshHandle mesh;
+    int lod; // level drawn last frame, for hysteresis
+
+    // All seven parts in one buffer, in the order draw() appends them:
+    // body, front-left brake and wheel, front-right brake and wheel, rear-left, rear-right
+    // Shared through MeshBatch::acquire, so a CarFleet of this model reuses it
+    std::shared_ptr<MeshBatch> batch;
+    std::vector<BatchPart> batchParts; // reused every frame
 
     // OpenGL handles
-    GLuint VAO;
-    GLuint vertexVBO, uvVBO, normalVBO;
-    GLuint EBO;
     GLuint textureID; // Added for texture
 
     // Transformation Matrix
-    glm::mat4 modelMatrix; // Added
-    void updateModelMatrixT(); // Helper to update the modelMatrix based on position, rotation, scale
-    void rotateModelMatrixAroundY();
-    void setPhaseBack();
+    glm::mat4 modelMatrix; // state.modelMatrix() with scale, set by applyState
 };
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "meshbatch.h"
+#include "renderview.h"
+
+class Shader;
+
+// How one part of a car moves relative to the body and how it is coloured.
+// Steering turns it about Y through steerPivot
+// (Front::setSteeringAngle), wheel spin about Z through
+// spinPivot (Wheel::updateModelMatrix). carFleet.vert applies the same
+// transform on the GPU.
+struct PartRig {
+    bool steers;
+    bool spins;
+    glm::vec3 steerPivot;
+    glm::vec3 spinPivot;
+    bool livery;     // takes the car's livery colour instead of color
+    glm::vec3 color;
+
+    glm::mat4 transform(const glm::mat4& carModel, float steering, float wheelSpin) const;
+};
+
+// Per-frame state of one car in the fleet
+struct FleetCar {
+    glm::mat4 model;
+    glm::vec3 livery;
+    float steering;  // radians
+    float wheelSpin; // radians
+};
+
+// Draws any number of cars of one model with hardware instancing. Each car is a
+// row of per-frame instance data (transform, livery, steering and spin angles), so
+// the number of draw calls depends on the parts, submeshes and LODs in use but
+// not on the number of cars.
+//
+// Cars whose bounding sphere is outside the view frustum are dropped before
+// anything is uploaded. The rest are grouped by the LOD of their body. Within a group every part is drawn
+// at the finest level any car in the group needs, so no car is drawn coarser
+// than its own selection.
+class CarFleet {
+public:
+    CarFleet();
+
+    CarFleet(const CarFleet&) = delete;
+    CarFleet& operator=(const CarFleet&) = delete;
+
+    // meshes[i] moves as rig[i]; the first part is the body. Must run on the GL context thread.
+    bool build(const std::vector<MeshHandle>& meshes, const std::vector<PartRig>& rig);
+    bool isBuilt() const { return batch != nullptr; }
+
+    // One instanced draw per group, part and submesh; the carFleet shader must be in use
+    void draw(Shader& shader, const std::vector<FleetCar>& cars, const RenderView& view);
+    // Baseline for the benchmark: one MeshBatch draw per car with the carBatch shader in use
+    void drawPerCar(const std::vector<FleetCar>& cars, const RenderView& view);
+
+private:
+    // Per-instance attributes 4-9 of carFleet.vert
+    struct InstanceData {
+        glm::mat4 model;
+        glm::vec4 livery;
+        glm::vec4 angles; // x steering, y wheel spin
+    };
+
+    // Geometry, shared with the Cars drawing the same meshes; draw() enables the
+    // instance attributes on its VAO and disables them again before returning
+    std::shared_ptr<MeshBatch> batch;
+    std::vector<PartRig> rig;
+    GLintptr instanceOffset; // this frame's instances in the stream buffer
+    glm::vec4 carSphere; // car space centre and radius, covering every part at any steering and spin
+
+    // Reused every frame
+    std::vector<int> partLods;            // cars x parts, kept for hysteresis
+    std::vector<InstanceData> instances;  // sorted by group
+    std::vector<size_t> groupStart;       // first instance of each group, plus the end
+    std::vector<int> groupPartLods;       // groups x parts
+    std::vector<BatchPart> batchParts;
+    std::vector<glm::vec4> worldSpheres;
+    std::vector<uint8_t> carVisible;
+
+    void computeBoundingSphere();
+    void cullCars(const std::vector<FleetCar>& cars, const RenderView& view);
+    void selectLods(const std::vector<FleetCar>& cars, const RenderView& view);
+    void setInstanceAttributes(size_t firstInstance);
+};
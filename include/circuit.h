@@ -4,6 +4,7 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <GL/glew.h>
 #include <Shader.h>
+#include "renderview.h"
 
 class Circuit {
 public:
@@ -11,7 +12,7 @@ public:
     ~Circuit();
 
     void setupGPUBuffers();
-    void draw(Shader& shader);
+    void draw(Shader& shader, const RenderView& view); // skipped when outside the view frustum
 
     void setPosition(const glm::vec3& pos);
     void setColor(const glm::vec3& col);
@@ -0,0 +1,37 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "vehicle.h"
+
+// Driver inputs over simulated time, for runs without a window (f1_sim)
+enum class Control { Throttle, Brake, Left, Right };
+
+struct ScriptedControl {
+    double time; // seconds from the start
+    Control control;
+    bool on;
+};
+
+struct ControlScript {
+    std::vector<ScriptedControl> events; // sorted by time
+    double duration = 0.0;               // the "end" line, else the last event
+};
+
+// Reads "<seconds> <throttle|brake|left|right> <on|off>" lines and an optional
+// "<seconds> end", e.g. "2.5 left on". Blank lines and lines starting with #
+// are skipped.
+bool loadControlScript(const std::string& path, ControlScript& script);
+
+// Plays a script into VehicleControls as simulated time advances
+class ControlPlayer {
+public:
+    explicit ControlPlayer(const ControlScript& script) : script(script), next(0) {}
+
+    // Applies every event up to time and returns the controls in effect
+    const VehicleControls& advance(double time);
+
+private:
+    const ControlScript& script;
+    size_t next;
+    VehicleControls controls;
+};
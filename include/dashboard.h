@@ -3,29 +3,56 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <vector>
-
-#include "shader.h" // 确保你包含了你的着色器类头文件
-
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include "shader.h"
+
+// One overlay vertex: screen position in pixels (origin top left) and RGBA8 colour
+struct OverlayVertex {
+    glm::vec2 position;
+    uint32_t color;
+};
+
+// Immediate-mode 2D overlay. Every primitive of a frame (gauge arcs, needles,
+// bars, text quads) is appended as coloured triangles to one vertex array,
+// which render() streams to the GPU and draws with a single glDrawArrays on
+// top of the scene. Lines are quads, so there are no glLineWidth calls.
 class Dashboard {
 public:
-    Dashboard(int windowWidth, int windowHeight);
+    Dashboard();
     ~Dashboard();
 
-    void render(float rpm);
+    Dashboard(const Dashboard&) = delete;
+    Dashboard& operator=(const Dashboard&) = delete;
+
+    // Loads dashBoard.vert/.frag and sets up the VAO; needs the GL context
+    bool initialize();
     void setWindowSize(int width, int height);
 
-private:
-    void setupGauge();
-    void setupNeedle();
+    // Primitives for the current frame; colours are RGBA in 0..1
+    void addRect(glm::vec2 min, glm::vec2 max, glm::vec4 color);
+    void addLine(glm::vec2 from, glm::vec2 to, float width, glm::vec4 color);
+    // Ring segment around center; angles in radians clockwise from straight up
+    void addArc(glm::vec2 center, float innerRadius, float outerRadius,
+                float startAngle, float endAngle, glm::vec4 color);
+    // Built-in 5x7 pixel font: digits, space and the letters of "RPM" and "KM/H".
+    // pixel is the size of one font pixel.
+    void addText(glm::vec2 topLeft, float pixel, const std::string& text, glm::vec4 color);
+
+    // Adds the RPM gauge and speed readout, then draws everything added this frame
+    void render(int rpm, float speed);
 
-    Shader shader;
+private:
+    std::unique_ptr<Shader> shader;
+    UniformHandle projectionUniform;
     int windowWidth;
     int windowHeight;
 
-    // RPM 表盘的 OpenGL 对象
-    GLuint gaugeVAO, gaugeVBO;
-    std::vector<glm::vec2> gaugeVertices;
+    GLuint VAO;
+    std::vector<OverlayVertex> vertices; // reused every frame
 
-    // RPM 指针的 OpenGL 对象
-    GLuint needleVAO, needleVBO;
-};
\ No newline at end of file
+    void addQuad(glm::vec2 a, glm::vec2 b, glm::vec2 c, glm::vec2 d, uint32_t color);
+    void flush();
+};
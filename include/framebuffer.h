@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+#include <GL/glew.h>
+
+// Offscreen render target: RGBA8 colour and 24-bit depth renderbuffers.
+// Used by the headless mode in place of the window's default framebuffer.
+class Framebuffer {
+public:
+    // Must run on the GL context thread; check isComplete() afterwards
+    Framebuffer(int width, int height);
+    ~Framebuffer();
+
+    Framebuffer(const Framebuffer&) = delete;
+    Framebuffer& operator=(const Framebuffer&) = delete;
+
+    bool isComplete() const { return complete; }
+    void bind() const;
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // Reads the colour buffer back as RGBA rows from top to bottom (blocks until rendering is done)
+    std::vector<unsigned char> readPixels() const;
+
+private:
+    GLuint FBO;
+    GLuint colorRBO, depthRBO;
+    int width, height;
+    bool complete;
+};
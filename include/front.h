@@ -6,6 +6,8 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <GL/glew.h>
 #include <Shader.h>
+#include "mesh.h"
+#include "meshbatch.h"
 #include <Wheel.h>
 
 class Car;
@@ -19,7 +21,8 @@ class Front {
 public:
     Front(int wheelConfig, const Car& car);
     ~Front();
-    void draw(Shader& carshader);
+    // Updates the transforms and appends this brake and its wheel to the car's batch parts
+    void appendParts(const RenderView& view, std::vector<BatchPart>& parts);
     void update(float deltaTime);
  
     // Setters
@@ -42,8 +45,7 @@ public:
 
 
     // Model loading and GPU buffer setup
-    bool loadModel(); // Returns true on success
-    void setupGPUBuffers(); // Pushes loaded vertices/indices to GPU
+    bool loadModel(); // Brake mesh only (Car loads the wheel); returns true on success
 
 private:
     const Car& car;
@@ -61,16 +63,11 @@ private:
     float turning;
     float angle;
 
-    // Model Data
-    std::vector<glm::vec3> vertices; 
-    std::vector<glm::vec2> uvs;
-    std::vector<glm::vec3> normals;
-    std::vector<unsigned int> indices;
+    // Shared mesh (parsed data, bounds and materials) from the MeshRegistry
+    MeshHandle mesh;
+    int lod; // level drawn last frame, for hysteresis
 
     // OpenGL handles
-    GLuint VAO;
-    GLuint vertexVBO, uvVBO, normalVBO;
-    GLuint EBO;
     GLuint textureID; // Added for texture
 
     // Transformation Matrix
@@ -78,7 +75,7 @@ private:
     glm::mat4 steeringMatrix;
     glm::mat4 steeringMatrixX;
     void updateModelMatrix(); // Helper to update the modelMatrix based on position, rotation, scale
-    void rotateModelMatrixAroundY_Simplified(float angleDegree);
+    void setSteeringAngle(float angleDegree); // about the hub, already clamped by the vehicle model
 
     friend class Car;
 };
\ No newline at end of file
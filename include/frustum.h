@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// The six clip planes of a projection * view matrix (Gribb & Hartmann), kept
+// structure-of-arrays so the tests run four planes or four spheres per SSE
+// instruction. Both tests are conservative: objects near a frustum corner can
+// pass without being on screen, but nothing visible is ever rejected.
+class Frustum {
+public:
+    Frustum(); // accepts everything
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    // Local-space AABB placed by model
+    bool intersectsBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& model) const;
+    // World-space box given by its centre and half extent
+    bool intersectsBox(const glm::vec3& center, const glm::vec3& extent) const;
+    // World-space spheres (xyz centre, w radius); visible[i] is set to 1 or 0
+    void intersectSpheres(const glm::vec4* spheres, size_t count, uint8_t* visible) const;
+
+private:
+    // Planes 6 and 7 only pad the arrays to two SSE registers and accept everything
+    alignas(16) float nx[8];
+    alignas(16) float ny[8];
+    alignas(16) float nz[8];
+    alignas(16) float d[8];
+};
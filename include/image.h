@@ -0,0 +1,8 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Writes 8-bit RGBA pixels (rows top to bottom) as a PNG. The image data is
+// stored uncompressed, which keeps the writer dependency-free; files are about
+// width * height * 4 bytes. Returns false if the file cannot be written.
+bool writePNG(const std::string& path, int width, int height, const std::vector<unsigned char>& rgba);
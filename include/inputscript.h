@@ -0,0 +1,15 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// One key event replayed at the start of a frame
+struct ScriptedKey {
+    long frame;
+    int key;    // GLFW_KEY_*
+    int action; // GLFW_PRESS or GLFW_RELEASE
+};
+
+// Reads "<frame> <key> <press|release>" lines, e.g. "120 LEFT press". Keys are
+// the ones key_callback handles: UP DOWN LEFT RIGHT W A S D Q E C. Blank lines
+// and lines starting with # are skipped. Events come back sorted by frame.
+bool loadInputScript(const std::string& path, std::vector<ScriptedKey>& events);
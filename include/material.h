@@ -0,0 +1,58 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+class Shader;
+
+// One newmtl block of a Wavefront .mtl file
+struct Material {
+    std::string name;
+    glm::vec3 diffuse;   // Kd
+    glm::vec3 specular;  // Ks
+    glm::vec3 emissive;  // Ke
+    float shininess;     // Ns
+    float opacity;       // d
+    std::string diffuseMap; // map_Kd, resolved against the .mtl directory; empty if none
+    GLuint texture;      // diffuse map texture; 0 until an image loader provides one
+};
+
+// Materials of every loaded .mtl file in one table, so draws from different
+// meshes can be sorted and compared by id. Id 0 is the default material (white,
+// untextured) used for faces without usemtl or with an unknown name.
+class MaterialLibrary {
+public:
+    static const unsigned int DEFAULT_MATERIAL = 0;
+
+    static MaterialLibrary& instance();
+
+    // Thread-safe. Parses each .mtl file once and returns the id of `name` in the
+    // first of the libraries that defines it.
+    unsigned int resolve(const std::vector<std::string>& libraries, const std::string& name);
+
+    const Material& get(unsigned int id) const;
+
+    // Uploads the material uniforms (materialDiffuse, materialEmissive) and binds the
+    // diffuse map, skipping both when the same program already has this material or
+    // texture bound. Must run on the GL context thread.
+    void bind(Shader& shader, unsigned int id);
+    // Forgets what is bound, e.g. after another program was used or at frame start
+    void resetBindings();
+
+private:
+    MaterialLibrary();
+
+    bool loadLibrary(const std::string& path);
+
+    mutable std::mutex mutex;
+    std::deque<Material> materials; // deque: references stay valid while loading continues
+    std::unordered_map<std::string, std::unordered_map<std::string, unsigned int>> libraries;
+
+    GLuint boundProgram;
+    unsigned int boundMaterial;
+    GLuint boundTexture;
+};
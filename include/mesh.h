@@ -0,0 +1,79 @@
+#pragma once
+#include <string>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <unordered_map>
+#include "objloader.h"
+#include "renderview.h"
+#include "vertexformat.h"
+
+// Screen-space error budget for LOD selection, and the fraction of it a coarser
+// level must stay under before it replaces the current one
+const float LOD_PIXEL_ERROR = 1.0f;
+const float LOD_HYSTERESIS = 0.75f;
+
+// Parsed mesh data, its bounds and resolved materials. One Mesh exists per asset
+// path and is shared by every part that draws it; MeshBatch owns the GPU copy.
+class Mesh {
+public:
+    explicit Mesh(const std::string& path);
+    ~Mesh();
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    int lodCount() const { return data.lods.empty() ? 1 : static_cast<int>(data.lods.size()); }
+    // Coarsest level whose simplification error projects to at most LOD_PIXEL_ERROR
+    // pixels at this placement. Coarsening from currentLod needs extra margin so a
+    // part sitting on a threshold doesn't flicker between two levels.
+    int selectLod(const glm::mat4& model, const RenderView& view, int currentLod) const;
+
+    const std::string& getPath() const { return path; }
+    const MeshData& getData() const { return data; }
+    // MaterialLibrary id of a submesh's material slot
+    unsigned int submeshMaterial(const MeshSubmesh& submesh) const;
+    glm::vec3 getBoundsMin() const { return boundsMin; }
+    glm::vec3 getBoundsMax() const { return boundsMax; }
+
+    // Vertex format of batches built after this call (MeshBatch::build)
+    static void setDefaultVertexFormat(VertexFormat format);
+    static VertexFormat getDefaultVertexFormat();
+
+private:
+    std::string path;
+    MeshData data;
+    glm::vec3 boundsMin, boundsMax;
+    std::vector<unsigned int> materialIds; // per material slot
+
+    void computeBounds();
+    // Maps submesh material slots to MaterialLibrary ids and sorts each LOD's submeshes by id
+    void resolveMaterials();
+
+    friend class MeshRegistry;
+};
+
+using MeshHandle = std::shared_ptr<Mesh>;
+
+// Reference-counted meshes keyed by asset path. The first acquire() parses the
+// file; concurrent acquires of the same path wait for that parse instead of
+// repeating it. A mesh is released with its last handle.
+class MeshRegistry {
+public:
+    static MeshRegistry& instance();
+
+    // Thread-safe. Returns nullptr if the asset cannot be loaded.
+    MeshHandle acquire(const std::string& path);
+
+    // Number of meshes currently alive
+    size_t liveCount() const;
+
+private:
+    struct Entry {
+        std::weak_ptr<Mesh> mesh;
+        std::shared_future<MeshHandle> loading; // valid while the first acquire is parsing
+    };
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+};
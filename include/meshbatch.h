@@ -0,0 +1,104 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "mesh.h"
+#include "uniformbuffer.h"
+
+// Draw records per multi-draw; BatchDrawData[MAX_BATCH_DRAWS] must fit the 16 KB
+// minimum uniform block size
+const unsigned int MAX_BATCH_DRAWS = 64;
+
+// One submesh draw; mirrors the std140 BatchDraws block in carBatch.vert
+struct BatchDrawData {
+    glm::mat4 model;
+    glm::mat4 normalMatrix;   // inverse transpose of the model's upper 3x3
+    glm::vec4 baseColor;      // part colour * material diffuse
+    glm::vec4 emissive;
+    glm::vec4 positionOffset; // packed position decode, see PackedVertex
+    glm::vec4 positionScale;
+};
+static_assert(sizeof(BatchDrawData) == 192, "BatchDrawData must match the std140 layout");
+
+// Per-frame state of one batch part
+struct BatchPart {
+    glm::mat4 model;
+    glm::vec3 color;
+    int lod;
+};
+
+// Several meshes packed into one vertex and index buffer behind a single VAO.
+// Each frame the submeshes of every part's LOD become draw records in the
+// BatchDraws uniform block (streamed, with the indirect commands, through
+// StreamBuffer) and are drawn with one glMultiDrawElementsIndirect;
+// the vertex shader finds its record through aDrawIndex, an instanced attribute
+// that baseInstance offsets. Without GL 4.3 (or ARB_multi_draw_indirect with
+// ARB_base_instance) it falls back to a glDrawElementsBaseVertex loop that sets
+// aDrawIndex as a constant attribute before each draw.
+class MeshBatch {
+public:
+    MeshBatch();
+    ~MeshBatch();
+
+    MeshBatch(const MeshBatch&) = delete;
+    MeshBatch& operator=(const MeshBatch&) = delete;
+
+    // Packs the meshes in the default vertex format; part i draws meshes[i] and
+    // null meshes draw nothing. Must run on the GL context thread.
+    bool build(const std::vector<MeshHandle>& meshes);
+    bool isBuilt() const { return VAO != 0; }
+    bool usesMultiDraw() const { return multiDraw; }
+
+    // parts[i] is this frame's state of part i; parts whose bounds fall outside the
+    // view frustum are skipped. The caller has the batch shader in use.
+    void draw(const std::vector<BatchPart>& parts, const RenderView& view);
+
+    // Lets --no-multi-draw force the fallback path on batches built after the call
+    static void setMultiDrawEnabled(bool enabled);
+
+    // The built batch of this mesh set, shared by every Car and CarFleet drawing it,
+    // so each set is uploaded once. Released with its last handle; nullptr if the
+    // build fails. GL context thread only.
+    static std::shared_ptr<MeshBatch> acquire(const std::vector<MeshHandle>& meshes);
+
+    // Where a part's mesh lives in the shared buffers
+    struct Part {
+        MeshHandle mesh;
+        GLint baseVertex;
+        GLuint firstIndex;
+        glm::vec3 positionOffset, positionScale; // packed position decode
+    };
+
+    // For renderers that issue their own draws from the batch's buffers (CarFleet)
+    size_t partCount() const { return parts.size(); }
+    const Part& part(size_t index) const { return parts[index]; }
+    GLuint vertexArray() const { return VAO; }
+
+private:
+    struct DrawElementsIndirectCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    std::vector<Part> parts;
+    VertexFormat format;
+    bool multiDraw;
+
+    // OpenGL handles
+    GLuint VAO;
+    GLuint vertexVBO, uvVBO, normalVBO; // Float uses all three, Packed only vertexVBO
+    GLuint drawIndexVBO;                // 0..MAX_BATCH_DRAWS-1, one per instance
+    GLuint EBO;
+
+    // Reused every frame
+    std::vector<BatchDrawData> drawData;
+    std::vector<DrawElementsIndirectCommand> commands;
+
+    void addDraw(const Part& part, const BatchPart& state, const glm::mat4& normalMatrix,
+                 GLuint indexOffset, GLuint indexCount, unsigned int material);
+    void flush();
+};
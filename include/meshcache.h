@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include "objloader.h"
+
+// Binary mesh cache stored next to the source OBJ (foo.obj -> foo.f1mesh).
+// The file is a fixed header followed by the position, uv, normal and index
+// arrays in exactly the layout glBufferData expects, then the LOD and submesh
+// tables and the material names, so loading is a memory
+// map plus one bulk copy per array.
+
+std::string meshCachePath(const std::string& objPath);
+
+// Loads the cache if its header matches the OBJ's current size and mtime.
+bool loadMeshCache(const std::string& objPath, MeshData& mesh);
+
+// Same, but when only the mtime differs the OBJ content hash decides;
+// a matching hash refreshes the stored mtime.
+bool loadMeshCache(const std::string& objPath, const std::string& objBytes, MeshData& mesh);
+
+// Writes the cache for a freshly parsed OBJ. Returns false if it cannot be written.
+bool saveMeshCache(const std::string& objPath, const std::string& objBytes, const MeshData& mesh);
@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include "objloader.h"
+
+// Post-transform cache size the optimizer targets and the statistics assume
+const unsigned int VERTEX_CACHE_SIZE = 32;
+
+struct VertexCacheStats {
+    size_t misses; // vertex shader invocations
+    float acmr;    // average cache miss ratio: misses per triangle (0.5 is ideal for grids, 3 is worst)
+    float atvr;    // average transformed vertex ratio: misses per vertex (1 is ideal)
+};
+
+// Simulates a FIFO post-transform cache over the index buffer
+VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount,
+                                    unsigned int cacheSize = VERTEX_CACHE_SIZE);
+
+// Reorders triangles for the post-transform cache (Forsyth's linear-speed algorithm)
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount,
+                         unsigned int cacheSize = VERTEX_CACHE_SIZE);
+
+// Splits a cache-optimized index buffer into clusters and sorts them outside-in so
+// outward-facing surfaces tend to be drawn before the ones they occlude. A cluster may
+// only be split where its ACMR stays within threshold times that of the whole run.
+void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions,
+                      float threshold = 1.05f, unsigned int cacheSize = VERTEX_CACHE_SIZE);
+
+// Renumbers vertices in order of first use so vertex fetches walk memory forwards.
+// Unreferenced vertices are dropped.
+void optimizeVertexFetch(MeshData& mesh);
+
+// Runs all three passes in order (cache, overdraw, fetch); cache and overdraw
+// reorder each submesh separately
+void optimizeMesh(MeshData& mesh);
@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Triangles of one material within one level of detail
+struct MeshSubmesh {
+    unsigned int material; // index into MeshData::materialNames
+    unsigned int indexOffset;
+    unsigned int indexCount;
+};
+
+// One level of detail: a range of MeshData::indices over the shared vertices,
+// split into consecutive submeshes
+struct MeshLod {
+    unsigned int indexOffset;
+    unsigned int indexCount;
+    float error; // largest object-space distance of a full-detail vertex from this level (0 for LOD 0)
+    unsigned int firstSubmesh;
+    unsigned int submeshCount;
+};
+
+// Indexed triangle mesh as produced by loadOBJ() and packed by MeshBatch::build()
+struct MeshData {
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec2> uvs;
+    std::vector<glm::vec3> normals;
+    std::vector<unsigned int> indices; // 3 per triangle, all LODs back to back
+    std::vector<MeshLod> lods;         // finest first; empty means one level covering all indices
+    std::vector<MeshSubmesh> submeshes;
+    std::vector<std::string> materialLibs;  // .mtl paths from mtllib, resolved against the OBJ
+    std::vector<std::string> materialNames; // usemtl names; "" for faces before any usemtl
+};
+
+// Loads a Wavefront OBJ file (v / vt / vn / f records). Each unique (v, vt, vn)
+// corner becomes one vertex and faces are emitted as an index list.
+// Positions are stored with the z/y/x axis swap the C44 assets expect.
+// Triangles are grouped into one submesh per usemtl material.
+// Fresh parses are reordered for the GPU (see meshopt.h) and get simplified
+// LODs appended (see simplify.h).
+// A binary cache (see meshcache.h) is used when it is up to date and rewritten
+// after every fresh parse. Returns false if the file cannot be read.
+// parseThreads == 0 parses files of 16 MB and up on all hardware threads.
+bool loadOBJ(const std::string& path, MeshData& mesh, unsigned int parseThreads = 0);
+
+// Parses OBJ text already in memory. With threads > 1 the text is split into
+// line-aligned chunks (at least 1 MB each) that are parsed concurrently and
+// merged; the result is bit-identical for every thread count.
+// Returns the number of face corners that referenced no valid position.
+size_t parseOBJText(const char* data, size_t size, MeshData& mesh, unsigned int threads);
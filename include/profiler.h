@@ -0,0 +1,122 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <GL/glew.h>
+
+// Frames kept for the rolling avg/p95/p99 statistics
+const int PROFILER_ROLLING_FRAMES = 240;
+// Frames of zone events kept for the Chrome trace dump
+const int PROFILER_TRACE_FRAMES = 600;
+// GPU timings are read this many frames after they were issued, when the
+// results are normally available, so reading them never stalls the pipeline
+const int PROFILER_QUERY_LATENCY = 4;
+
+// Scoped CPU zones and GPU timer queries, with rolling per-zone statistics and
+// a Chrome trace (chrome://tracing, Perfetto) dump of the last frames.
+// Disabled by default; zones then cost one branch. CPU zones may be recorded
+// from any thread; GPU zones only on the GL context thread.
+class Profiler {
+public:
+    static Profiler& instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+
+    // Frame boundaries on the GL thread. beginFrame collects the GPU timings
+    // issued PROFILER_QUERY_LATENCY frames ago.
+    void beginFrame();
+    void endFrame();
+
+    // Zone names are stored by pointer and must outlive the profiler (use literals)
+    void recordCpuZone(const char* name, int64_t startUs, int64_t endUs);
+    // GPU zones bracket GL commands with GL_TIMESTAMP queries and may nest
+    void beginGpuZone(const char* name);
+    void endGpuZone();
+
+    // Microseconds since the profiler was created
+    int64_t nowUs() const;
+
+    // Average, p95 and p99 per zone over the last PROFILER_ROLLING_FRAMES frames
+    void printStats(std::ostream& out = std::cout) const;
+    // Writes the retained events as Chrome trace JSON; returns false if the file cannot be written
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    Profiler();
+
+    struct TraceEvent {
+        const char* name;
+        int track; // thread index, or GPU_TRACK
+        int64_t startUs;
+        int64_t durationUs;
+        long frame;
+    };
+
+    struct GpuZone {
+        const char* name;
+        GLuint beginQuery;
+        GLuint endQuery; // 0 while open
+    };
+
+    // Queries and zones of one in-flight frame
+    struct QueryFrame {
+        std::vector<GLuint> queries;
+        size_t used = 0;
+        std::vector<GpuZone> zones;
+        long frame = -1;
+        int64_t gpuToCpuUs = 0; // add to a GPU timestamp (in us) to get profiler time
+    };
+
+    struct ZoneStats {
+        std::vector<double> samples; // ms per frame, ring of PROFILER_ROLLING_FRAMES
+        size_t next = 0;
+    };
+
+    static const int GPU_TRACK = 0;
+
+    bool enabled;
+    std::chrono::steady_clock::time_point epoch;
+    long frame;
+    int64_t frameStartUs;
+
+    mutable std::mutex mutex; // guards everything below
+    std::deque<TraceEvent> events;
+    std::unordered_map<std::string, double> frameTotals; // ms per zone in the current frame
+    std::unordered_map<std::string, ZoneStats> stats;
+    int nextTrack;
+
+    // GL thread only
+    QueryFrame queryFrames[PROFILER_QUERY_LATENCY];
+    std::vector<size_t> openGpuZones;
+    bool timerQueries;
+    unsigned long droppedGpuFrames;
+
+    int currentTrack();
+    GLuint nextQuery(QueryFrame& slot);
+    void collectGpuFrame(QueryFrame& slot);
+    void addSample(const std::string& zone, double ms);
+};
+
+// Records a CPU zone for its scope; with Gpu it also times the GL commands issued inside it
+class ProfileZone {
+public:
+    enum Kind { Cpu, Gpu };
+
+    explicit ProfileZone(const char* name, Kind kind = Cpu);
+    ~ProfileZone();
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* name;
+    Kind kind;
+    int64_t startUs;
+    bool active;
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <GL/glew.h>
+
+// Disk cache of linked program binaries (glGetProgramBinary/glProgramBinary).
+// One file per program in PROGRAM_CACHE_DIR, named after a key that hashes the
+// shader sources together with the GL vendor, renderer and version strings, so
+// a shader edit or a driver update simply misses the cache. A binary the driver
+// rejects anyway is deleted and the program is built from source again.
+
+const char* const PROGRAM_CACHE_DIR = "shadercache";
+
+// --no-shader-cache; also off when the driver has no binary formats
+void setProgramCacheEnabled(bool enabled);
+bool programCacheAvailable();
+
+uint64_t programCacheKey(const std::string& vertexSource, const std::string& fragmentSource);
+
+// Returns a linked program made from the cached binary, or 0 on a miss
+GLuint loadProgramBinary(uint64_t key);
+
+// Stores a linked program created with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+// Returns false if the binary cannot be retrieved or written.
+bool saveProgramBinary(uint64_t key, GLuint program);
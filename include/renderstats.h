@@ -0,0 +1,28 @@
+#pragma once
+
+// Draw-side counters for profiling. Main resets them every frame.
+struct RenderStats {
+    unsigned long drawCalls = 0;
+    unsigned long triangles = 0;
+    unsigned long vaoBinds = 0;
+    unsigned long materialBinds = 0; // material uniform uploads that were not redundant
+    unsigned long textureBinds = 0;
+    unsigned long visibleObjects = 0; // frustum tests passed (car parts, fleet cars, ground)
+    unsigned long culledObjects = 0;  // frustum tests failed; nothing was submitted for them
+
+    void reset() { *this = RenderStats(); }
+
+    RenderStats& operator+=(const RenderStats& other) {
+        drawCalls += other.drawCalls;
+        triangles += other.triangles;
+        vaoBinds += other.vaoBinds;
+        materialBinds += other.materialBinds;
+        textureBinds += other.textureBinds;
+        visibleObjects += other.visibleObjects;
+        culledObjects += other.culledObjects;
+        return *this;
+    }
+};
+
+// Counters for the frame being drawn
+RenderStats& frameStats();
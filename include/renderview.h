@@ -0,0 +1,15 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "frustum.h"
+
+// Per-frame camera state the draw calls need beyond the shader uniforms
+struct RenderView {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec3 cameraPos;
+    float viewportHeight; // pixels
+    Frustum frustum;      // of projection * view
+
+    // Pixels covered by one world unit at distance 1 along the view axis
+    float pixelsPerUnit() const { return 0.5f * viewportHeight * projection[1][1]; }
+};
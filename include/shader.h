@@ -2,6 +2,8 @@
 #include <GL/glew.h>
 #include <iostream>
 #include <string>
+#include <cstdint>
+#include <unordered_map>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -16,6 +18,22 @@ GLuint compileShader(const char* shaderSource, GLenum shaderType);
 
 GLuint createShaderProgram(const char* vertexShaderPath, const char* fragmentShaderPath);
 
+// Uniform location resolved once after linking. -1 means the program has no such
+// active uniform; glUniform* ignores it, just like a failed glGetUniformLocation.
+struct UniformHandle {
+    GLint location = -1;
+};
+
+// Per-draw uniforms shared by the scene shaders, resolved when the program links
+struct DrawUniforms {
+    UniformHandle model;
+    UniformHandle objectColor;
+    UniformHandle positionOffset;
+    UniformHandle positionScale;
+    UniformHandle materialDiffuse;
+    UniformHandle materialEmissive;
+};
+
 class Shader {
     public:
         GLuint ID; // Program ID
@@ -27,43 +45,80 @@ class Shader {
         //     }
         // }
 
-        Shader(const char* vertexShaderPath, const char* fragmentShaderPath) {
-            ID = createShaderProgram(vertexShaderPath, fragmentShaderPath);
-            if (ID == 0) {
-                std::cerr << "Failed to create shader program." << std::endl;
-            }
+        // Takes the program from the binary cache (programcache.h) when it can; otherwise
+        // starts compiling and linking and returns without waiting for the driver, which
+        // works in the background with KHR_parallel_shader_compile
+        Shader(const char* vertexShaderPath, const char* fragmentShaderPath);
 
-        }
+        // Waits for a pending link, reports errors, stores the binary in the cache and
+        // builds the uniform table. use() calls it the first time if nobody has;
+        // uniform() and drawUniforms() are empty until then.
+        bool finish();
+        bool isFromCache() const { return fromCache; }
+
+        Shader(const Shader&) = delete;
+        Shader& operator=(const Shader&) = delete;
     
         // 激活 Shader
         void use() {
+            if (pending) finish();
             glUseProgram(ID);
         }
     
+        // Looks the name up in the table built at link time (no GL call)
+        UniformHandle uniform(const std::string& name) const {
+            auto it = locations.find(name);
+            return it != locations.end() ? it->second : UniformHandle();
+        }
+        const DrawUniforms& drawUniforms() const {
+            return draw;
+        }
+
         // 设置 uniform 变量的辅助函数
-        void setBool(const std::string& name, bool value) const {
-            glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+        void setBool(UniformHandle handle, bool value) const {
+            glUniform1i(handle.location, (int)value);
+        }
+        void setInt(UniformHandle handle, int value) const {
+            glUniform1i(handle.location, value);
         }
-        void setInt(const std::string& name, int value) const {
-            glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        void setFloat(UniformHandle handle, float value) const {
+            glUniform1f(handle.location, value);
         }
-        void setFloat(const std::string& name, float value) const {
-            glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+        void setVec3(UniformHandle handle, float x, float y, float z) const {
+            glUniform3f(handle.location, x, y, z);
         }
-        void setVec3(const std::string& name, float x, float y, float z) const {
-            glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+        void setVec3(UniformHandle handle, const glm::vec3& value) const {
+            glUniform3fv(handle.location, 1, &value[0]);
         }
-        void setVec3(const std::string& name, const glm::vec3& value) const {
-            glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+        void setVec4(UniformHandle handle, const glm::vec4& value) const {
+            glUniform4fv(handle.location, 1, &value[0]);
         }
-        void setMat4(const std::string& name, const glm::mat4& mat) const {
-            glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        void setMat4(UniformHandle handle, const glm::mat4& mat) const {
+            glUniformMatrix4fv(handle.location, 1, GL_FALSE, &mat[0][0]);
         }
+
+        // By-name versions for setup code; per-draw code should keep a handle instead
+        void setBool(const std::string& name, bool value) const { setBool(uniform(name), value); }
+        void setInt(const std::string& name, int value) const { setInt(uniform(name), value); }
+        void setFloat(const std::string& name, float value) const { setFloat(uniform(name), value); }
+        void setVec3(const std::string& name, float x, float y, float z) const { setVec3(uniform(name), x, y, z); }
+        void setVec3(const std::string& name, const glm::vec3& value) const { setVec3(uniform(name), value); }
+        void setVec4(const std::string& name, const glm::vec4& value) const { setVec4(uniform(name), value); }
+        void setMat4(const std::string& name, const glm::mat4& mat) const { setMat4(uniform(name), mat); }
     
         // 析构函数，清理资源
-        ~Shader() {
-            if (ID != 0) {
-                glDeleteProgram(ID);
-            }
-        }
+        ~Shader();
+
+    private:
+        // Fills the location table and binds known uniform blocks to their binding points
+        void reflect();
+
+        std::string vertexPath, fragmentPath;
+        GLuint vertexShader, fragmentShader; // alive until finish()
+        bool pending;   // linked but not checked yet
+        bool cacheable; // store the binary under cacheKey once linked
+        bool fromCache;
+        uint64_t cacheKey;
+        std::unordered_map<std::string, UniformHandle> locations;
+        DrawUniforms draw;
     };
\ No newline at end of file
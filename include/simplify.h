@@ -0,0 +1,28 @@
+#pragma once
+#include <vector>
+#include <glm/glm.hpp>
+#include "objloader.h"
+
+// Quadric error metric (Garland & Heckbert) edge-collapse simplification.
+// Vertices only ever collapse onto a neighbouring existing vertex, so the
+// result indexes the same vertex buffer as the input. Vertices on open
+// borders never move, which keeps silhouettes crack-free. Vertices on
+// attribute seams (same position, different uv/normal) collapse with all
+// their wedges at once and only where every wedge has a matching target, so
+// texture seams stay closed.
+//
+// Stops at targetIndexCount or once the next collapse's quadric error (the
+// RMS distance to the planes merged into it, object-space units) would exceed
+// maxError, whichever comes first. resultError receives the largest distance
+// of an input vertex from the triangles around the vertex it collapsed into,
+// an estimate of the real deviation rather than the quadric error.
+std::vector<unsigned int> simplifyMesh(const std::vector<glm::vec3>& positions,
+                                       const std::vector<unsigned int>& indices,
+                                       size_t targetIndexCount, float maxError,
+                                       float* resultError = nullptr);
+
+// Appends up to three coarser levels (1/2, 1/4, 1/8 of the triangles) of the
+// mesh's first LOD to its index buffer and records them in mesh.lods. Each
+// submesh is simplified on its own, so levels keep the material split.
+// Stops adding levels once one would save less than 10% over the previous one.
+void buildMeshLods(MeshData& mesh);
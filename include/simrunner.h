@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "vehicle.h"
+#include "controlscript.h"
+
+// Offline runs of the vehicle model: no window, audio or threads, fixed steps
+// as fast as the CPU allows.
+
+struct TrajectorySample {
+    double time;
+    VehicleState state;
+    VehicleControls controls;
+};
+
+struct SimResult {
+    VehicleState final;
+    double time = 0.0;     // simulated seconds
+    long steps = 0;
+    float distance = 0.0f; // m travelled
+    float topSpeed = 0.0f; // m/s
+};
+
+// Loads the four tire.ini files (paths::FRONTLEFT ...) into params.tires;
+// returns false if any was missing (that tire keeps its defaults)
+bool loadCarTires(VehicleParams& params);
+
+// Steps the car through script.duration seconds at rateHz. With a trajectory,
+// the state is recorded before the first step, every sampleEvery steps and
+// after the last one.
+SimResult runControlScript(const ControlScript& script, const VehicleState& initial, const VehicleParams& params,
+                           double rateHz, std::vector<TrajectorySample>* trajectory = nullptr, int sampleEvery = 1);
+
+// time,x,y,z,heading,speed,... one row per sample
+bool writeTrajectoryCSV(const std::string& path, const std::vector<TrajectorySample>& samples);
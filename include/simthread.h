@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include "vehicle.h"
+#include "triplebuffer.h"
+
+class CarAudio;
+
+// Default physics rate (--physics-hz); every step is exactly 1/rate seconds
+const double SIM_RATE_HZ = 240.0;
+// Spiral-of-death cap: at most this much time is simulated per update, at any
+// --physics-hz. Time beyond it (a stall, the first frame after loading) is
+// dropped rather than caught up.
+const double SIM_MAX_CATCH_UP_SECONDS = 0.25;
+
+// What the simulation publishes after every update
+struct VehicleSnapshot {
+    VehicleState previous;
+    VehicleState current;
+    VehicleControls controls; // inputs of the step that produced current
+    double time = 0.0;        // SimThread clock (seconds) that current corresponds to
+    float alpha = 1.0f;       // lockstep only: leftover time after current, in steps
+};
+
+// Runs the vehicle dynamics, and the engine audio that follows them, with a
+// fixed time step on a thread of its own. Real time is collected in an
+// accumulator and spent in whole steps, so the results don't depend on the
+// frame rate. Each update publishes an immutable snapshot through a triple
+// buffer; the render thread takes the newest one every frame and
+// interpolates between its two states, so neither side waits for the other
+// and the render rate can drop without changing the physics.
+//
+// Headless runs don't start() the thread and call advance() with the frame
+// time instead: the same fixed steps, reproducible frame by frame.
+class SimThread {
+public:
+    // audio may be null; when set it is only touched by the simulation from now on
+    SimThread(const VehicleState& initial, const VehicleParams& params, CarAudio* audio,
+              double rateHz = SIM_RATE_HZ);
+    ~SimThread();
+
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    void start();
+    void stop();
+    bool isRunning() const { return thread.joinable(); }
+
+    // Any thread; used from the next step on
+    void setControls(const VehicleControls& controls);
+
+    // Without the thread: adds dt seconds to the accumulator and runs the whole steps in it
+    void advance(double dt);
+
+    // Render thread: the state to draw now
+    VehicleState sample();
+
+    // Simulation totals; read them after stop() (or from the thread calling advance())
+    long steps() const { return stepCount; }
+    double droppedSeconds() const { return dropped; }
+    double stepSeconds() const { return step; }
+
+private:
+    VehicleState state;   // simulation side only
+    VehicleState previous; // state one step before, simulation side only
+    VehicleParams params;
+    CarAudio* audio;
+    std::atomic<uint8_t> controlBits;
+    std::atomic<bool> running;
+    std::thread thread;
+    TripleBuffer<VehicleSnapshot> snapshots;
+    std::chrono::steady_clock::time_point epoch;
+    double step;          // seconds per step
+    double accumulator;   // real time not yet simulated
+    double simTime;       // SimThread clock time of state
+    long stepCount;
+    double dropped;
+
+    double now() const;
+    VehicleControls controls() const;
+    void run();
+    void update(double elapsed);
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+
+// Frames the CPU may run ahead of the GPU; the persistent buffer has one region per frame
+const int STREAM_BUFFER_FRAMES = 3;
+// Bytes of dynamic data one frame may upload
+const size_t STREAM_BUFFER_FRAME_SIZE = 4 * 1024 * 1024;
+
+// A piece of the current frame's stream buffer
+struct StreamAllocation {
+    GLuint buffer = 0;
+    GLintptr offset = 0;
+    size_t size = 0;
+
+    bool valid() const { return buffer != 0; }
+};
+
+// Per-frame dynamic GPU data (uniform blocks, instance attributes, indirect
+// commands) sub-allocated linearly from one buffer object, reset every frame.
+//
+// With ARB_buffer_storage the buffer holds STREAM_BUFFER_FRAMES regions and
+// stays persistently and coherently mapped; uploads are a memcpy. beginFrame
+// moves to the next region and waits on the fence endFrame left there, so
+// the CPU never overwrites data the GPU may still read. Without it (GL 3.3)
+// the buffer is orphaned at the start of every frame and uploads use
+// glBufferSubData.
+//
+// Allocations are only valid until the next beginFrame. Must be used on the
+// GL context thread, between initialize() and shutdown().
+class StreamBuffer {
+public:
+    static StreamBuffer& instance();
+
+    bool initialize(size_t frameSize = STREAM_BUFFER_FRAME_SIZE);
+    // Releases the buffer; call while the context is still current
+    void shutdown();
+    bool isPersistent() const { return mapped != nullptr; }
+
+    void beginFrame();
+    // Fences the frame's region; call after its last draw
+    void endFrame();
+
+    // Copies size bytes into the frame's region. Returns an invalid allocation
+    // (and warns once) when the frame has run out of space.
+    StreamAllocation upload(const void* data, size_t size, size_t alignment = 16);
+    // Uploads a uniform block and binds it to binding. reserve pads the range for
+    // blocks declared larger than the data (e.g. arrays that are partly filled).
+    bool uploadUniforms(GLuint binding, const void* data, size_t size, size_t reserve = 0);
+
+    size_t peakBytes() const { return peakUsed; }
+    // Times beginFrame had to block because the GPU was STREAM_BUFFER_FRAMES behind
+    unsigned long fenceWaits() const { return waits; }
+
+private:
+    StreamBuffer();
+
+    GLuint buffer;
+    char* mapped; // persistent mapping of all regions, or nullptr when orphaning
+    size_t frameSize;
+    size_t used;     // bytes allocated in the current frame
+    size_t peakUsed;
+    int region;
+    GLsync fences[STREAM_BUFFER_FRAMES];
+    GLint uniformAlignment;
+    bool overflowReported;
+    unsigned long waits;
+
+    StreamAllocation allocate(size_t size, size_t alignment);
+    void write(const StreamAllocation& allocation, const void* data, size_t size);
+};
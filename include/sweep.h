@@ -0,0 +1,82 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include "vehicle.h"
+#include "controlscript.h"
+
+// Grid sweeps of the car setup: every combination of the axis values is
+// simulated on its own, spread over all cores (f1_sweep).
+
+// Speed below which a braking car counts as stopped, m/s
+constexpr float SWEEP_STOP_SPEED = 0.5f;
+
+// Script events closer together than this (or than twice the jitter) form one
+// manoeuvre, which --jitter shifts as a whole, s
+constexpr double SWEEP_JITTER_CLUSTER_GAP = 1.0;
+
+struct SweepAxis {
+    std::string name;          // one of sweepParameterNames()
+    std::vector<float> values;
+};
+
+enum class SweepMetric {
+    StoppingDistance, // m from startSpeed, brakes on after the reaction delay, until SWEEP_STOP_SPEED
+    LapTime           // s to cover lapDistance following the script
+};
+
+struct SweepConfig {
+    VehicleParams base;
+    std::vector<SweepAxis> axes;
+    SweepMetric metric = SweepMetric::StoppingDistance;
+    ControlScript script;        // LapTime inputs; without events the throttle is held
+    float startSpeed = 0.0f;     // m/s
+    float lapDistance = 1000.0f; // m
+    double maxTime = 120.0;      // s before a run counts as not finished
+    double rateHz = 240.0;
+    int samples = 1;             // runs per grid point, each with its own seed
+    double jitter = 0.0;         // s: the reaction delay before braking, or +- on every cluster of script events
+    uint64_t seed = 1;
+    unsigned threads = 0;        // 0: one per hardware thread
+};
+
+struct SweepRow {
+    std::vector<float> values; // per axis
+    float mean = 0.0f;         // over the finished samples
+    float min = 0.0f;
+    float max = 0.0f;
+    int finished = 0;          // samples that finished within maxTime
+};
+
+struct SweepResult {
+    std::vector<SweepRow> rows; // grid order, the last axis changing fastest
+    size_t jobs = 0;
+    unsigned threads = 0; // workers that ran, at most one per job
+    double wallMs = 0.0;
+};
+
+// The VehicleParams fields an axis can vary, plus tire grip scales
+const std::vector<std::string>& sweepParameterNames();
+bool setSweepParameter(VehicleParams& params, const std::string& name, float value);
+
+// "name=min:max:count" or "name=a,b,c"
+bool parseSweepAxis(const std::string& spec, SweepAxis& axis);
+
+// Seed of one job, from the sweep seed and the job index only, so results
+// don't depend on the thread count or on which worker ran the job
+uint64_t sweepSeed(uint64_t seed, size_t job);
+
+// One simulation; returns the metric and whether it finished within maxTime
+float runSweepJob(const SweepConfig& config, const VehicleParams& params, uint64_t seed, bool& finished);
+
+// Calls job(i) for i in [0, count) on threads workers. Each worker walks its
+// own slice of the range and steals half of the largest remaining slice when
+// it runs out, so uneven jobs still keep every core busy. threads 0 means one
+// per hardware thread; never more than count are started. Returns the number used.
+unsigned parallelFor(size_t count, unsigned threads, const std::function<void(size_t)>& job);
+
+SweepResult runSweep(const SweepConfig& config);
+
+// One row per grid point: the axis values, mean, min, max, finished
+bool writeSweepCSV(const std::string& path, const SweepConfig& config, const SweepResult& result);
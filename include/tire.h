@@ -0,0 +1,62 @@
+#pragma once
+#include <string>
+
+// Slip-based tire forces from the Pacejka "Magic Formula"
+//   F = Fz * D * sin(C * atan(B*x - E*(B*x - atan(B*x))))
+// with x the slip ratio (longitudinal) or slip angle in radians (lateral) and
+// D the peak friction coefficient, so forces scale with the wheel load Fz.
+
+namespace paths {
+    const std::string BASE_PATH = "assets/F1_car/newC44/";
+    const std::string TIRE_INI_SUFFIX = "/tire.ini";
+
+    const std::string FRONTLEFT  = BASE_PATH + "frontleft" + TIRE_INI_SUFFIX;
+    const std::string FRONTRIGHT = BASE_PATH + "frontright" + TIRE_INI_SUFFIX;
+    const std::string REARLEFT   = BASE_PATH + "rearleft" + TIRE_INI_SUFFIX;
+    const std::string REARRIGHT  = BASE_PATH + "rearright" + TIRE_INI_SUFFIX;
+}
+
+// Wheel order used by every per-wheel array
+enum TireIndex { TIRE_FRONT_LEFT, TIRE_FRONT_RIGHT, TIRE_REAR_LEFT, TIRE_REAR_RIGHT, TIRE_COUNT };
+
+struct MagicFormula {
+    float B; // stiffness factor
+    float C; // shape factor
+    float D; // peak friction coefficient
+    float E; // curvature factor
+};
+
+struct TireParams {
+    MagicFormula longitudinal = { 11.0f, 1.65f, 1.6f, 0.3f };
+    MagicFormula lateral = { 9.0f, 1.4f, 1.5f, -0.6f };
+    float radius = 0.36f;  // m, loaded radius
+    float inertia = 1.2f;  // kg m^2, wheel and brake disc about the axle
+};
+
+// Reads a tire.ini (sections [tire], [longitudinal], [lateral]); keys that are
+// missing keep their defaults. Returns false, leaving tire untouched, if the
+// file can't be parsed.
+bool loadTireParams(const std::string& path, TireParams& tire);
+
+// The four tires' coefficients as structure of arrays, one lane per wheel
+struct alignas(16) TireSet {
+    float Bx[TIRE_COUNT], Cx[TIRE_COUNT], Dx[TIRE_COUNT], Ex[TIRE_COUNT];
+    float By[TIRE_COUNT], Cy[TIRE_COUNT], Dy[TIRE_COUNT], Ey[TIRE_COUNT];
+
+    void set(int wheel, const TireParams& tire);
+};
+
+// Inputs and outputs of one evaluation of all four wheels
+struct alignas(16) TireBatch {
+    float slipRatio[TIRE_COUNT];
+    float slipAngle[TIRE_COUNT]; // radians
+    float load[TIRE_COUNT];      // N, vertical
+    float fx[TIRE_COUNT];        // N, along the wheel
+    float fy[TIRE_COUNT];        // N, across the wheel
+    float stiffness[TIRE_COUNT]; // N per unit slip ratio, slope of fx before the ellipse (0 past the peak)
+};
+
+// Combined-slip forces for all four wheels: each direction from its own
+// curve, then scaled back onto the friction ellipse. Branch-free over the
+// lanes (polynomial atan/sin), so the compiler vectorizes it.
+void evaluateTires(const TireSet& tires, TireBatch& batch);
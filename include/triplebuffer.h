@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer, single-consumer hand-over of the latest value.
+// The writer fills writeBuffer() and publishes it; the reader picks up the
+// newest published value with fetch() and keeps reading it until the next
+// fetch. Neither side ever waits: of the three slots one is being written,
+// one read, and the middle one holds the latest published value.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), writeIndex(0), readIndex(2) {}
+
+    // Writer thread
+    T& writeBuffer() { return slots[writeIndex].value; }
+    void publish() {
+        writeIndex = middle.exchange(writeIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader thread; returns false (and keeps the current value) if nothing new was published
+    bool fetch() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;
+        }
+        readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    const T& read() const { return slots[readIndex].value; }
+
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t FRESH = 0x4; // the middle slot holds a value the reader hasn't fetched
+
+    // Own cache lines, so the two threads don't contend on neighbouring slots
+    struct alignas(64) Slot {
+        T value;
+    };
+
+    Slot slots[3];
+    std::atomic<uint8_t> middle;
+    uint8_t writeIndex; // writer only
+    uint8_t readIndex;  // reader only
+};
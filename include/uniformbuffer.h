@@ -0,0 +1,23 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+// Uniform block binding points shared by every program. Shader binds any block
+// with one of these names to its point when it links.
+const GLuint FRAME_DATA_BINDING = 0;
+const GLuint BATCH_DRAWS_BINDING = 1;
+
+// Per-frame camera and light data; mirrors the std140 FrameData block in the shaders.
+// vec3s are stored as vec4 because std140 pads them to 16 bytes anyway.
+struct FrameData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 lightPos;
+    glm::vec4 lightColor;
+    glm::vec4 cameraPos;
+};
+static_assert(sizeof(FrameData) == 176, "FrameData must match the std140 layout");
+
+// Binding point for a uniform block name, or GL_INVALID_INDEX if it has none
+GLuint uniformBlockBinding(const char* blockName);
@@ -1,8 +1,25 @@
 #pragma once
 
 #include<iostream>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 void printMat4(const glm::mat4& mat);
+
+
+// Wall-clock milliseconds elapsed since start
+double millisecondsSince(std::chrono::steady_clock::time_point start);
+
+// 64-bit FNV-1a; pass a previous result as hash to continue it over more bytes
+uint64_t hashBytes(const std::string& bytes, uint64_t hash = 0xcbf29ce484222325ull);
+
+// Middle value (upper middle for even counts); 0 for an empty list
+double median(std::vector<double> values);
+
+// Prints frame count, mean, median, 95th percentile and worst frame time
+void printFrameTimeSummary(const std::string& label, std::vector<double> frameMs);
\ No newline at end of file
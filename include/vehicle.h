@@ -0,0 +1,77 @@
+#pragma once
+#include <glm/glm.hpp>
+#include "tire.h"
+
+// Vehicle dynamics with no GL, audio or mesh dependencies, so the simulation
+// can run on its own thread (simthread.h) or in tools without a display.
+
+// Driver inputs, latched from the keyboard
+struct VehicleControls {
+    bool throttle = false;
+    bool brake = false;
+    bool left = false;
+    bool right = false;
+};
+
+enum class VehicleModel {
+    Kinematic, // bicycle-model yaw, fixed throttle/brake accelerations (the original handling)
+    Tire       // rigid body on four slip-based tires (tire.h) with load transfer
+};
+
+// Setup constants
+struct VehicleParams {
+    VehicleModel model = VehicleModel::Tire;
+
+    float wheelbase = 2.7f;         // m, front to rear axle
+    float maxSteeringAngle = 30.0f; // degrees
+    float steeringRate = 60.0f;     // degrees per second while a steering key is held
+    float maxSpeed = 300.0f;        // m/s
+    float wheelRadius = 0.65f;      // m, of the drawn wheel, for the wheel spin angle
+
+    // Kinematic model
+    float throttleForce = 100.0f;   // m/s^2 along the heading
+    float brakeForce = 10.0f;       // m/s^2 against the velocity
+    float dragCoefficient = 2.0f;   // deceleration per m/s of speed
+
+    // Tire model
+    float mass = 798.0f;            // kg, with driver
+    float yawInertia = 1100.0f;     // kg m^2
+    float frontWeight = 0.45f;      // static share of the weight on the front axle
+    float cgHeight = 0.3f;          // m
+    float trackWidth = 1.6f;        // m
+    float dragArea = 1.4f;          // m^2, drag coefficient times frontal area
+    float downforceArea = 3.5f;     // m^2, lift coefficient times frontal area
+    float aeroBalance = 0.45f;      // share of the downforce on the front axle
+    float maxDriveForce = 8000.0f;  // N at the rear contact patches
+    float enginePower = 750000.0f;  // W, caps the drive force at speed
+    float maxBrakeForce = 25000.0f; // N at all four contact patches
+    float brakeBias = 0.58f;        // share of the braking on the front axle
+    float rollingResistance = 0.015f;
+    TireParams tires[TIRE_COUNT];   // per wheel, from the tire.ini files
+};
+
+// Complete state of one car; plain data, cheap to copy into snapshots
+struct VehicleState {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 velocity = glm::vec3(0.0f);
+    glm::vec3 acceleration = glm::vec3(0.0f); // external, applied and cleared by the next step
+    float heading = 0.0f;   // radians about +Y; 0 faces +X
+    float yawRate = 0.0f;   // radians per second
+    float steering = 0.0f;  // front wheel angle in degrees, positive to the left
+    float wheelSpin = 0.0f; // radians the drawn wheels have rolled since the start
+
+    // Tire model only
+    float wheelSpeed[TIRE_COUNT] = {};            // rad/s
+    glm::vec2 bodyAcceleration = glm::vec2(0.0f); // m/s^2 forward and left, for load transfer
+
+    // Rotation by heading, translated to position (no scale)
+    glm::mat4 modelMatrix() const;
+    float speed() const;
+    int rpm() const;
+};
+
+// Advances the state by dt seconds with params.model
+void stepVehicle(VehicleState& state, const VehicleControls& controls, const VehicleParams& params, float dt);
+
+// State between a (t = 0) and b (t = 1), for rendering between two steps
+VehicleState interpolate(const VehicleState& a, const VehicleState& b, float t);
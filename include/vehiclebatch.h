@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "vehicle.h"
+
+// Lanes per kernel iteration; storage is padded to a multiple of this
+const size_t VEHICLE_BATCH_LANES = 8;
+
+// Many cars' kinematic state (VehicleModel::Kinematic) as structure of arrays,
+// so one step of every car streams through contiguous floats instead of
+// chasing Car objects. With AVX2 (build with F1_AVX2) step() advances eight
+// cars per instruction; otherwise it runs the same arithmetic one car at a
+// time. All cars share one VehicleParams; external accelerations and the tire
+// model are not supported here.
+class VehicleBatch {
+public:
+    explicit VehicleBatch(const VehicleParams& params = VehicleParams());
+
+    // Returns the new car's index
+    size_t add(const VehicleState& state);
+    void clear();
+    size_t size() const { return count; }
+
+    void setControls(size_t car, const VehicleControls& controls);
+    VehicleState state(size_t car) const;
+    const VehicleParams& getParams() const { return params; }
+
+    // Advances every car by dt seconds, like stepVehicle with the kinematic model
+    void step(float dt);
+    // Whether step() was compiled with the AVX2 kernel
+    static bool vectorized();
+
+    // Contiguous per-car arrays (size() valid entries, then padding)
+    const float* positionX() const { return posX.data(); }
+    const float* positionZ() const { return posZ.data(); }
+    const float* headings() const { return heading.data(); }
+
+private:
+    VehicleParams params;
+    size_t count;
+
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> heading;
+    std::vector<float> yawRate;
+    std::vector<float> steering; // degrees
+    std::vector<float> wheelSpin;
+    // Control inputs: throttle and brake 0 or 1, steer +1 left, -1 right, 0 held
+    std::vector<float> throttle, brake, steer;
+
+    void stepScalar(size_t begin, size_t end, float dt);
+    size_t stepAVX2(float dt); // returns how many cars it stepped (none without AVX2)
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "objloader.h"
+
+enum class VertexFormat {
+    Float,  // separate float VBOs: vec3 position, vec2 uv, vec3 normal (32 bytes per vertex)
+    Packed  // one interleaved VBO: unorm16 position within the mesh bounds,
+            // 10_10_10_2 normal, half-float uv (16 bytes per vertex)
+};
+
+// Interleaved layout for VertexFormat::Packed, decoded in the vertex shaders with
+// pos = positionOffset + aPos * positionScale
+struct PackedVertex {
+    uint16_t position[4]; // xyz as unorm16 across the mesh bounds, w unused
+    uint32_t normal;      // snorm 10_10_10_2
+    uint16_t uv[2];       // half floats
+};
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay 16 bytes");
+
+// Packs every vertex of data with positions relative to [boundsMin, boundsMax]
+std::vector<PackedVertex> packVertices(const MeshData& data, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+// Points attributes 0-2 (position, uv, normal) at the PackedVertex array in the
+// bound GL_ARRAY_BUFFER and enables them
+void setPackedVertexAttributes();
@@ -6,6 +6,9 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <GL/glew.h>
 #include <Shader.h>
+#include "mesh.h"
+#include "meshbatch.h"
+#include "tire.h"
 
 class Car;
 class Front;
@@ -14,21 +17,12 @@ class Front;
 #define RIGHTWHEEL 2
 #define MAXSTEERINGANGLE 30.0f
 
-namespace paths {
-    const std::string BASE_PATH = "assets/F1_car/newC44/";
-    const std::string TIRE_INI_SUFFIX = "/tire.ini";
-
-    const std::string FRONTLEFT  = BASE_PATH + "frontleft" + TIRE_INI_SUFFIX;
-    const std::string FRONTRIGHT = BASE_PATH + "frontright" + TIRE_INI_SUFFIX;
-    const std::string REARLEFT   = BASE_PATH + "rearleft" + TIRE_INI_SUFFIX;
-    const std::string REARRIGHT  = BASE_PATH + "rearright" + TIRE_INI_SUFFIX;
-}
-
 class Wheel {
 public:
     Wheel(int wheelConfig, const Car& car, const Front* front=nullptr);
     ~Wheel();
-    void draw(Shader& carshader);
+    // Updates the transform and appends this wheel to the car's batch parts
+    void appendParts(const RenderView& view, std::vector<BatchPart>& parts);
     void update(float deltaTime);
  
     // Setters
@@ -49,8 +43,10 @@ public:
     glm::vec3 getColor() const { return color; }
 
     // Model loading and GPU buffer setup
-    bool loadModel(); // Returns true on success
-    void setupGPUBuffers(); // Pushes loaded vertices/indices to GPU
+    bool loadModel(); // Mesh and tire.ini; returns true if the mesh loaded
+
+    // Magic Formula coefficients from this wheel's tire.ini (defaults if it is missing)
+    const TireParams& getTire() const { return tire; }
 
 private:
     const Car& car;
@@ -65,17 +61,13 @@ private:
     bool breakStatus;
     float turning;
     float angle;
+    TireParams tire;
 
-    // Model Data
-    std::vector<glm::vec3> vertices; 
-    std::vector<glm::vec2> uvs;
-    std::vector<glm::vec3> normals;
-    std::vector<unsigned int> indices;
+    // Shared mesh (parsed data, bounds and materials) from the MeshRegistry
+    MeshHandle mesh;
+    int lod; // level drawn last frame, for hysteresis
 
     // OpenGL handles
-    GLuint VAO;
-    GLuint vertexVBO, uvVBO, normalVBO;
-    GLuint EBO;
     GLuint textureID; // Added for texture
 
     // Transformation Matrix
@@ -1,47 +1,28 @@
 #include "Car.h" 
+#include "threadpool.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <vector>
 #include <filesystem>
 #include <cmath>
+#include <algorithm>
 
 // Constructor: Initialize member variables
 Car::Car()
-    : position(0.0f, 0.0f, 0.0f),
-      velocity(0.0f, 0.0f, 0.0f),
-      acceleration(0.0f, 0.0f, 0.0f),
-      color(1.0f, 0.0f, 0.0f), // Default red color
+    : color(1.0f, 0.0f, 0.0f), // Default red color
       scale(1.0f, 1.0f, 1.0f),
-      breakTime(0.0f),
-      angularVelocity(0.0f),
-      angle(0.0f),
-      deltaAngle(0.0f),
-      throttleStatus(false), breakStatus(false), leftStatus(false), rightStatus(false),
       carAudio(),
       frontLeft(LEFTWHEEL, *this), frontRight(RIGHTWHEEL, *this),
       rearLeft(LEFTWHEEL, *this), rearRight(RIGHTWHEEL, *this),
-      VAO(0), vertexVBO(0), uvVBO(0), normalVBO(0), textureID(0)
+      lod(0),
+      textureID(0)
 {
     modelMatrix = glm::mat4(1.0f);
-    updateModelMatrixT(); // Initialize model matrix
+    applyState(state); // Initialize model matrix
 }
 
 // Destructor: Clean up OpenGL resources
 Car::~Car() {
-    if (VAO != 0) {
-        glDeleteVertexArrays(1, &VAO);
-    }
-    if (vertexVBO != 0) {
-        glDeleteBuffers(1, &vertexVBO);
-    }
-    if (uvVBO != 0){
-        glDeleteBuffers(1, &uvVBO);
-    }
-    if (normalVBO != 0){
-        glDeleteBuffers(1, &normalVBO);
-    }
     // If you manage textures within the class, delete it here
     if (textureID != 0) {
         glDeleteTextures(1, &textureID);
@@ -50,114 +31,51 @@ Car::~Car() {
     carAudio.shutdown();
 }
 
-// Update the car's state based on time
-void Car::update(float deltaTime) {
-    Car::deltaTime = deltaTime;
-    // Apply throttle force if throttle is pressed
-    if (throttleStatus) {
-        glm::vec3 forwardDirection = glm::normalize(glm::vec3(modelMatrix[0]));
-        acceleration += forwardDirection * 100.0f; // Throttle force
-    }
-    else{
-        // std::cout << "no throttle" << std::endl;
-    }
-    
-    // Apply braking force if brake is pressed
-    if (breakStatus) {
-        if (glm::length(velocity) > 0.0f) {
-            glm::vec3 brakeDirection = -glm::normalize(velocity);
-            acceleration += brakeDirection * 10.0f; // Braking force
-        }
-    }
-    
-    // Apply friction/drag forces (always present)
-    if (glm::length(velocity) > 0.0f) {
-        glm::vec3 dragDirection = -glm::normalize(velocity);
-        acceleration += dragDirection * 2.0f * glm::length(velocity); // Velocity-dependent drag
-    }
-    
-    // Apply steering forces if turning
-    if (leftStatus || rightStatus) {
-        float steeringAngle = leftStatus ? 1.0f : -1.0f;
-        frontLeft.rotateModelMatrixAroundY_Simplified(steeringAngle);
-        frontRight.rotateModelMatrixAroundY_Simplified(steeringAngle);
-    }
-    
-    // Euler integration for physics
-    velocity += acceleration * deltaTime;
-
-    // for the angular velocity
-    angularVelocity = std::tan(glm::radians(frontLeft.angle)) * glm::length(velocity) / FRONTAXIS;
-    deltaAngle = angularVelocity * deltaTime;
-    rotateModelMatrixAroundY();
-    
-    // Clamp velocity to reasonable limits
-    float maxSpeed = 300.0f;
-    if (glm::length(velocity) > maxSpeed) {
-        velocity = glm::normalize(velocity) * maxSpeed;
-    }
-    
-    position += velocity * deltaTime;
-    acceleration = glm::vec3(0.0f);
-    updateModelMatrixT();
-    
-    float throttleIntensity = throttleStatus ? 1.0f : 0.0f;
-    float brakeIntensity = breakStatus ? 1.0f : 0.0f;
-    int rpm = int(glm::length(velocity) * 20) ; // Convert speed to RPM
-    
-    carAudio.update(throttleIntensity, brakeIntensity, rpm);
+void Car::applyState(const VehicleState& newState) {
+    state = newState;
+    modelMatrix = glm::scale(state.modelMatrix(), scale);
+    frontLeft.setSteeringAngle(state.steering);
+    frontRight.setSteeringAngle(state.steering);
+    frontLeft.wheel.turning = state.wheelSpin;
+    frontRight.wheel.turning = state.wheelSpin;
+    rearLeft.turning = state.wheelSpin;
+    rearRight.turning = state.wheelSpin;
 }
 
-void Car::draw(Shader& carshader) {
-    if (VAO == 0) {
-        std::cerr << "Warning: Car VAO is not set up. Call setupGPUBuffers() first." << std::endl;
+void Car::draw(const RenderView& view) {
+    if (!batch) {
+        std::cerr << "Warning: Car mesh is not set up. Call setupGPUBuffers() first." << std::endl;
         return;
     }
 
-    // Pass the model matrix to the shader
-    carshader.setMat4("model", modelMatrix);
-    carshader.setVec3("objectColor", color);
-
-    // Bind the VAO and draw
-    glBindVertexArray(VAO);
-    if (!indices.empty()) {
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
-        std::cout<<"indices is not empty: "<< std::endl;
-    } else {
-        // If no indices, assume a simple array of vertices (e.g., triangle list)
-        glDrawArrays(GL_TRIANGLES, 0, vertices.size()); // Assuming 3 floats per vertex position
-    }
-    glBindVertexArray(0); // Unbind VAO
+    batchParts.clear();
+    lod = mesh->selectLod(modelMatrix, view, lod);
+    batchParts.push_back({ modelMatrix, color, lod });
+    frontLeft.appendParts(view, batchParts);
+    frontRight.appendParts(view, batchParts);
+    rearLeft.appendParts(view, batchParts);
+    rearRight.appendParts(view, batchParts);
 
-    frontLeft.draw(carshader);
-    frontRight.draw(carshader);
-    rearLeft.draw(carshader);
-    rearRight.draw(carshader);
-    // glUseProgram(0); // Unuse shader program.
+    batch->draw(batchParts, view);
 }
 
 void Car::setPosition(const glm::vec3& newPosition) {
-    position = newPosition;
-    updateModelMatrixT();
+    VehicleState moved = state;
+    moved.position = newPosition;
+    applyState(moved);
 }
 
 void Car::setVelocity(const glm::vec3& newVelocity) {
-    velocity = newVelocity;
+    state.velocity = newVelocity;
 }
 
 void Car::updateAcceleration(const glm::vec3& deltaAcceleration) {
-    acceleration += deltaAcceleration;
+    state.acceleration += deltaAcceleration;
     // std::cout << "updating Acceleration to " << acceleration[0] << std::endl; 
 }
 
 void Car::addBreak(bool status){
-    breakStatus = status;
-}
-
-void Car::rotateModelMatrixAroundY() {
-    angle += deltaAngle;
-    modelMatrix = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 1.0f, 0.0f));
-    velocity = glm::mat3(modelMatrix) * glm::length(velocity) * glm::vec3({1,0,0});
+    controls.brake = status;
 }
 
 void Car::setColor(const glm::vec3& newColor) {
@@ -166,162 +84,73 @@ void Car::setColor(const glm::vec3& newColor) {
 
 void Car::setScale(const glm::vec3& newScale) {
     scale = newScale;
-    updateModelMatrixT();
+    applyState(state);
 }
 
 bool Car::loadModel() {
-    // Initialize audio system when loading the model
+    // The seven part meshes are independent, so parse them all at once.
+    // Only CPU-side data is produced here; GL uploads stay in setupGPUBuffers().
+    ThreadPool pool(std::min(8u, std::max(1u, std::thread::hardware_concurrency())));
+
+    auto mainBodyLoaded = pool.submit([this]() {
+        const char* mainModelPath = "assets/F1_car/newC44/mainbody/mainbody.obj";
+        mesh = MeshRegistry::instance().acquire(mainModelPath);
+        return mesh != nullptr;
+    });
+
+    std::future<bool> parts[] = {
+        pool.submit([this]() { return frontLeft.loadModel(); }),
+        pool.submit([this]() { return frontRight.loadModel(); }),
+        pool.submit([this]() { return frontLeft.wheel.loadModel(); }),
+        pool.submit([this]() { return frontRight.wheel.loadModel(); }),
+        pool.submit([this]() { return rearLeft.loadModel(); }),
+        pool.submit([this]() { return rearRight.loadModel(); }),
+    };
+
+    // The OpenAL device and context are created on this thread, while the parts load
     if (!carAudio.initialize()) {
         std::cerr << "Warning: Failed to initialize car audio system" << std::endl;
     }
-    
-    const char* mainModelPath = "assets/F1_car/newC44/mainbody/mainbody.obj";
-    std::ifstream file(mainModelPath);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open OBJ file: " << mainModelPath << std::endl;
-        return false;
-    }
-
-    std::vector<glm::vec3> temp_positions;
-    std::vector<glm::vec2> temp_uvs;
-    std::vector<glm::vec3> temp_normals;
-
-    std::string line;
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        std::string prefix;
-        iss >> prefix;
-
-        if (prefix == "v") {
-            glm::vec3 vertex;
-            iss >> vertex.z >> vertex.y >> vertex.x;
-            temp_positions.push_back(vertex);
-        }
-        else if (prefix == "vt"){
-            glm::vec2 uv;
-            iss >> uv.x >> uv.y;
-            temp_uvs.push_back(uv);
-        }
-        else if (prefix == "vn"){
-            glm::vec3 normal;
-            iss >> normal.x >> normal.y >> normal.z;
-            temp_normals.push_back(normal);
-        }
-        else if (prefix == "f") {
-            std::string vertex_str;
-            int vertexIndex[3], uvIndex[3], normalIndex[3];
-            char slash;
-            
-            for (int i=0; i<3; i++){
-                iss >> vertex_str;
-                std::stringstream v_ss(vertex_str);
-
-                if (vertex_str.find("//") != std::string::npos) {
-                    // Format: v//vn
-                    v_ss >> vertexIndex[i] >> slash >> slash >> normalIndex[i];
-                    uvIndex[i] = 0; // No UV provided
-                } else if (vertex_str.find("/") != std::string::npos) {
-                    // Format: v/vt or v/vt/vn
-                    v_ss >> vertexIndex[i] >> slash;
-                    if (v_ss.peek() != '/') { // Check if there's a vt
-                        v_ss >> uvIndex[i];
-                    } else { // It's v/ /vn
-                        uvIndex[i] = 0; // No UV provided
-                    }
-                    if (v_ss.peek() == '/') { // Check if there's a vn
-                        v_ss >> slash >> normalIndex[i];
-                    } else {
-                        normalIndex[i] = 0; // No Normal provided
-                    }
-                } else {
-                    // Format: v (only position)
-                    v_ss >> vertexIndex[i];
-                    uvIndex[i] = 0;
-                    normalIndex[i] = 0;
-                }
-
-                // OBJ indices are 1-based, so subtract 1 for 0-based vector access
-                // Add the actual data to our output vectors
-                if (vertexIndex[i] > 0 && vertexIndex[i] <= temp_positions.size()) {
-                    vertices.push_back(temp_positions[vertexIndex[i] - 1]);
-                } else {
-                    std::cerr << "Warning: Invalid vertex index in face: " << vertexIndex[i] << std::endl;
-                    // Handle error: perhaps push a default/zeroed vertex
-                    vertices.push_back({0,0,0});
-                }
-
-                if (uvIndex[i] > 0 && uvIndex[i] <= temp_uvs.size()) {
-                    uvs.push_back(temp_uvs[uvIndex[i] - 1]);
-                } else {
-                    // If no UV is provided or invalid, push a default
-                    uvs.push_back({0,0});
-                }
-
-                if (normalIndex[i] > 0 && normalIndex[i] <= temp_normals.size()) {
-                    normals.push_back(temp_normals[normalIndex[i] - 1]);
-                } else {
-                    // If no normal is provided or invalid, push a default
-                    normals.push_back({0,0,0});
-                }
-            }
-
-        }
-        // Add more parsing for "vt" (texture coordinates) and "vn" (normals)
-        // and handle faces that reference them (e.g., f v/vt/vn)
+    // Missing wheel/brake meshes are reported by the parts themselves and are not fatal
+    for (auto& part : parts) {
+        part.get();
     }
-    file.close();
-    std::cout << "OBJ file loaded. Vertices: " << vertices.size()
-              << ", UVs: " << uvs.size()
-              << ", Normals: " << normals.size() << std::endl;
-
-    frontLeft.loadModel();
-    frontRight.loadModel();
-    rearLeft.loadModel();
-    rearRight.loadModel();
-
-    return true;
+    params.tires[TIRE_FRONT_LEFT] = frontLeft.wheel.getTire();
+    params.tires[TIRE_FRONT_RIGHT] = frontRight.wheel.getTire();
+    params.tires[TIRE_REAR_LEFT] = rearLeft.getTire();
+    params.tires[TIRE_REAR_RIGHT] = rearRight.getTire();
+    return mainBodyLoaded.get();
 }
 
-// Set up GPU buffers (VAO, VBOs)
+// Set up GPU buffers (one VAO, VBOs and EBO for the whole car)
 void Car::setupGPUBuffers() {
-    if (vertices.empty()) {
-        std::cerr << "Error: No vertex data to set up GPU buffers. Load a model first." << std::endl;
+    if (!mesh) {
+        std::cerr << "Error: No mesh to set up GPU buffers. Load a model first." << std::endl;
         return;
     }
+    batch = MeshBatch::acquire(partMeshes());
+}
 
-    // Generate and bind VAO
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-
-    // Generate and bind VBO (for vertex)
-    glGenBuffers(1, &vertexVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, vertexVBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), &vertices[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    // Generate and bond VBO for uv coordinates
-    glGenBuffers(1, &uvVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, uvVBO);
-    glBufferData(GL_ARRAY_BUFFER, uvs.size() * sizeof(glm::vec2), &uvs[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
-    glEnableVertexAttribArray(1);
-
-    // Generate and binf VBO for normal 
-    glGenBuffers(1, &normalVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, normalVBO);
-    glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3), &normals[0], GL_STATIC_DRAW);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
-    glEnableVertexAttribArray(2);
-
-    glBindVertexArray(0);
+std::vector<MeshHandle> Car::partMeshes() const {
+    return { mesh,
+             frontLeft.mesh, frontLeft.wheel.mesh,
+             frontRight.mesh, frontRight.wheel.mesh,
+             rearLeft.mesh, rearRight.mesh };
+}
 
-    std::cout << "GPU buffers for car model set up successfully." << std::endl;
+std::vector<PartRig> Car::partRig() const {
+    const glm::vec3 none(0.0f);
+    return { { false, false, none, none, true, color },
+             { true, false, frontLeft.shift, none, false, frontLeft.color },
+             { true, true, frontLeft.shift, frontLeft.wheel.shift, false, frontLeft.wheel.color },
+             { true, false, frontRight.shift, none, false, frontRight.color },
+             { true, true, frontRight.shift, frontRight.wheel.shift, false, frontRight.wheel.color },
+             { false, true, none, rearLeft.shift, false, rearLeft.color },
+             { false, true, none, rearRight.shift, false, rearRight.color } };
+}
 
-    frontLeft.setupGPUBuffers();
-    frontRight.setupGPUBuffers();
-    rearLeft.setupGPUBuffers();
-    rearRight.setupGPUBuffers();
+FleetCar Car::fleetState() const {
+    return { modelMatrix, color, glm::radians(state.steering), state.wheelSpin };
 }
 
 // Dummy texture loading for demonstration (you'd use a real image loading library)
@@ -351,32 +180,19 @@ void Car::setTexture(const std::string& texturePath) {
     }
 }
 
-// Private helper to update the model matrix
-void Car::updateModelMatrixT() {
-    modelMatrix[3] = glm::vec4(position, 1.0f);
-    modelMatrix = glm::scale(modelMatrix, scale);
-}
-
-void Car::setPhaseBack(){
-    throttleStatus = false;
-    breakStatus = false;
-    leftStatus = false;
-    rightStatus = false;
-}
-
 // Phase register
 void Car::setThrottle(bool status){
-    throttleStatus = status;
+    controls.throttle = status;
 }
 
 void Car::setBreak(bool status){
-    breakStatus = status;
+    controls.brake = status;
 }
 
 void Car::setDeltaLeft(bool status){
-    leftStatus = status;
+    controls.left = status;
 }
 
 void Car::setDeltaRight(bool status){
-    rightStatus = status;
+    controls.right = status;
 }
\ No newline at end of file
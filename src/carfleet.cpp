@@ -0,0 +1,259 @@
+#include "carfleet.h"
+#include "shader.h"
+#include "material.h"
+#include "renderstats.h"
+#include "streambuffer.h"
+#include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <glm/gtc/matrix_transform.hpp>
+
+glm::mat4 PartRig::transform(const glm::mat4& carModel, float steering, float wheelSpin) const {
+    glm::mat4 model = carModel;
+    if (steers) {
+        model = model * glm::translate(glm::mat4(1.0f), steerPivot)
+                      * glm::rotate(glm::mat4(1.0f), steering, glm::vec3(0.0f, 1.0f, 0.0f))
+                      * glm::translate(glm::mat4(1.0f), -steerPivot);
+    }
+    if (spins) {
+        model = model * glm::translate(glm::mat4(1.0f), spinPivot)
+                      * glm::rotate(glm::mat4(1.0f), wheelSpin, glm::vec3(0.0f, 0.0f, 1.0f))
+                      * glm::translate(glm::mat4(1.0f), -spinPivot);
+    }
+    return model;
+}
+
+CarFleet::CarFleet()
+    : instanceOffset(0), carSphere(0.0f)
+{
+}
+
+bool CarFleet::build(const std::vector<MeshHandle>& meshes, const std::vector<PartRig>& partRig) {
+    if (meshes.size() != partRig.size() || meshes.empty()) {
+        std::cerr << "Error: Fleet needs one rig entry per part mesh" << std::endl;
+        return false;
+    }
+    batch = MeshBatch::acquire(meshes);
+    if (!batch) {
+        return false;
+    }
+    rig = partRig;
+    computeBoundingSphere();
+    return true;
+}
+
+void CarFleet::computeBoundingSphere() {
+    // A sphere per part that holds it in any pose: rotating parts get one around their
+    // pivot (a steered wheel around the steering pivot, reaching out past its own axle)
+    std::vector<glm::vec4> partSpheres;
+    for (size_t p = 0; p < rig.size(); ++p) {
+        const MeshHandle& mesh = batch->part(p).mesh;
+        if (!mesh) continue;
+        glm::vec3 lo = mesh->getBoundsMin(), hi = mesh->getBoundsMax();
+        auto reach = [&](const glm::vec3& pivot) {
+            float farthest = 0.0f;
+            for (int corner = 0; corner < 8; ++corner) {
+                glm::vec3 point(corner & 1 ? hi.x : lo.x, corner & 2 ? hi.y : lo.y, corner & 4 ? hi.z : lo.z);
+                farthest = glm::max(farthest, glm::length(point - pivot));
+            }
+            return farthest;
+        };
+        const PartRig& partRig = rig[p];
+        if (partRig.spins && partRig.steers) {
+            float radius = glm::length(partRig.spinPivot - partRig.steerPivot) + reach(partRig.spinPivot);
+            partSpheres.push_back(glm::vec4(partRig.steerPivot, radius));
+        } else if (partRig.spins) {
+            partSpheres.push_back(glm::vec4(partRig.spinPivot, reach(partRig.spinPivot)));
+        } else if (partRig.steers) {
+            partSpheres.push_back(glm::vec4(partRig.steerPivot, reach(partRig.steerPivot)));
+        } else {
+            partSpheres.push_back(glm::vec4(0.5f * (lo + hi), 0.5f * glm::length(hi - lo)));
+        }
+    }
+
+    // Enclose them all around the first (the body) sphere's centre
+    glm::vec3 center = partSpheres.empty() ? glm::vec3(0.0f) : glm::vec3(partSpheres[0]);
+    float radius = 0.0f;
+    for (const glm::vec4& sphere : partSpheres) {
+        radius = glm::max(radius, glm::length(glm::vec3(sphere) - center) + sphere.w);
+    }
+    carSphere = glm::vec4(center, radius);
+}
+
+void CarFleet::cullCars(const std::vector<FleetCar>& cars, const RenderView& view) {
+    worldSpheres.resize(cars.size());
+    for (size_t c = 0; c < cars.size(); ++c) {
+        const glm::mat4& model = cars[c].model;
+        float scale = glm::max(glm::length(glm::vec3(model[0])),
+                               glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+        worldSpheres[c] = glm::vec4(glm::vec3(model * glm::vec4(glm::vec3(carSphere), 1.0f)), carSphere.w * scale);
+    }
+    carVisible.resize(cars.size());
+    view.frustum.intersectSpheres(worldSpheres.data(), worldSpheres.size(), carVisible.data());
+
+    RenderStats& stats = frameStats();
+    for (uint8_t visible : carVisible) {
+        if (visible) ++stats.visibleObjects;
+        else ++stats.culledObjects;
+    }
+}
+
+void CarFleet::setInstanceAttributes(size_t firstInstance) {
+    // GL 3.3 has no baseInstance for plain instanced draws, so each group re-points the attributes
+    const size_t base = instanceOffset + firstInstance * sizeof(InstanceData);
+    for (GLuint column = 0; column < 4; ++column) {
+        glVertexAttribPointer(4 + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(base + offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+    }
+    glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(base + offsetof(InstanceData, livery)));
+    glVertexAttribPointer(9, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void*)(base + offsetof(InstanceData, angles)));
+}
+
+void CarFleet::selectLods(const std::vector<FleetCar>& cars, const RenderView& view) {
+    const size_t partCount = rig.size();
+    partLods.resize(cars.size() * partCount, 0);
+
+    int groupCount = batch->part(0).mesh ? batch->part(0).mesh->lodCount() : 1;
+    std::vector<size_t> groupSize(groupCount, 0);
+    for (size_t c = 0; c < cars.size(); ++c) {
+        if (!carVisible[c]) continue;
+        const FleetCar& car = cars[c];
+        for (size_t p = 0; p < partCount; ++p) {
+            const MeshHandle& mesh = batch->part(p).mesh;
+            int& lod = partLods[c * partCount + p];
+            lod = mesh ? mesh->selectLod(rig[p].transform(car.model, car.steering, car.wheelSpin), view, lod) : 0;
+        }
+        ++groupSize[partLods[c * partCount]];
+    }
+
+    // Counting sort of the cars by body LOD
+    groupStart.assign(groupCount + 1, 0);
+    for (int g = 0; g < groupCount; ++g) {
+        groupStart[g + 1] = groupStart[g] + groupSize[g];
+    }
+    groupPartLods.assign(groupCount * partCount, 0);
+    for (int g = 0; g < groupCount; ++g) {
+        for (size_t p = 0; p < partCount; ++p) {
+            groupPartLods[g * partCount + p] = batch->part(p).mesh ? batch->part(p).mesh->lodCount() - 1 : 0;
+        }
+    }
+    instances.resize(groupStart.back());
+    std::vector<size_t> next(groupStart.begin(), groupStart.end() - 1);
+    for (size_t c = 0; c < cars.size(); ++c) {
+        if (!carVisible[c]) continue;
+        int group = partLods[c * partCount];
+        for (size_t p = 0; p < partCount; ++p) {
+            int& groupLod = groupPartLods[group * partCount + p];
+            groupLod = std::min(groupLod, partLods[c * partCount + p]);
+        }
+        const FleetCar& car = cars[c];
+        instances[next[group]++] = { car.model, glm::vec4(car.livery, 1.0f), glm::vec4(car.steering, car.wheelSpin, 0.0f, 0.0f) };
+    }
+}
+
+void CarFleet::draw(Shader& shader, const std::vector<FleetCar>& cars, const RenderView& view) {
+    if (!isBuilt() || cars.empty()) {
+        return;
+    }
+    cullCars(cars, view);
+    selectLods(cars, view);
+    if (instances.empty()) {
+        return;
+    }
+
+    StreamAllocation instanceData = StreamBuffer::instance().upload(instances.data(), instances.size() * sizeof(InstanceData),
+                                                                    sizeof(glm::vec4));
+    if (!instanceData.valid()) {
+        return;
+    }
+    instanceOffset = instanceData.offset;
+    // Attribute pointers capture the buffer bound here
+    glBindBuffer(GL_ARRAY_BUFFER, instanceData.buffer);
+
+    RenderStats& stats = frameStats();
+    glBindVertexArray(batch->vertexArray());
+    ++stats.vaoBinds;
+    // The multi-draw path's draw index array holds MAX_BATCH_DRAWS entries at divisor 1;
+    // fleet draws run more instances than that and must not read it
+    if (batch->usesMultiDraw()) {
+        glDisableVertexAttribArray(3);
+    }
+    for (GLuint attribute = 4; attribute <= 9; ++attribute) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+
+    const DrawUniforms& uniforms = shader.drawUniforms();
+    UniformHandle steerPivot = shader.uniform("partSteerPivot");
+    UniformHandle spinPivot = shader.uniform("partSpinPivot");
+    UniformHandle livery = shader.uniform("partLivery");
+    MaterialLibrary& materials = MaterialLibrary::instance();
+    const size_t partCount = rig.size();
+
+    for (size_t g = 0; g + 1 < groupStart.size(); ++g) {
+        GLsizei instanceCount = static_cast<GLsizei>(groupStart[g + 1] - groupStart[g]);
+        if (instanceCount == 0) continue;
+        setInstanceAttributes(groupStart[g]);
+
+        for (size_t p = 0; p < partCount; ++p) {
+            const MeshBatch::Part& part = batch->part(p);
+            if (!part.mesh) continue;
+            const PartRig& partRig = rig[p];
+            shader.setVec4(steerPivot, glm::vec4(partRig.steerPivot, partRig.steers ? 1.0f : 0.0f));
+            shader.setVec4(spinPivot, glm::vec4(partRig.spinPivot, partRig.spins ? 1.0f : 0.0f));
+            shader.setFloat(livery, partRig.livery ? 1.0f : 0.0f);
+            shader.setVec3(uniforms.objectColor, partRig.color);
+            shader.setVec3(uniforms.positionOffset, part.positionOffset);
+            shader.setVec3(uniforms.positionScale, part.positionScale);
+
+            const MeshData& data = part.mesh->getData();
+            auto drawRange = [&](unsigned int indexOffset, unsigned int indexCount, unsigned int material) {
+                materials.bind(shader, material);
+                glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(indexCount), GL_UNSIGNED_INT,
+                                                  (void*)((part.firstIndex + indexOffset) * sizeof(unsigned int)),
+                                                  instanceCount, part.baseVertex);
+                ++stats.drawCalls;
+                stats.triangles += static_cast<unsigned long>(indexCount / 3) * instanceCount;
+            };
+            if (data.lods.empty() || data.submeshes.empty()) {
+                drawRange(0, static_cast<unsigned int>(data.indices.size()), MaterialLibrary::DEFAULT_MATERIAL);
+                continue;
+            }
+            const MeshLod& range = data.lods[groupPartLods[g * partCount + p]];
+            for (unsigned int s = range.firstSubmesh; s < range.firstSubmesh + range.submeshCount; ++s) {
+                const MeshSubmesh& submesh = data.submeshes[s];
+                drawRange(submesh.indexOffset, submesh.indexCount, part.mesh->submeshMaterial(submesh));
+            }
+        }
+    }
+
+    // The batch's own draw path must not see instanced arrays left enabled
+    for (GLuint attribute = 4; attribute <= 9; ++attribute) {
+        glDisableVertexAttribArray(attribute);
+    }
+    if (batch->usesMultiDraw()) {
+        glEnableVertexAttribArray(3);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void CarFleet::drawPerCar(const std::vector<FleetCar>& cars, const RenderView& view) {
+    if (!isBuilt()) {
+        return;
+    }
+    const size_t partCount = rig.size();
+    partLods.resize(cars.size() * partCount, 0);
+    for (size_t c = 0; c < cars.size(); ++c) {
+        const FleetCar& car = cars[c];
+        batchParts.clear();
+        for (size_t p = 0; p < partCount; ++p) {
+            const MeshHandle& mesh = batch->part(p).mesh;
+            glm::mat4 model = rig[p].transform(car.model, car.steering, car.wheelSpin);
+            int& lod = partLods[c * partCount + p];
+            lod = mesh ? mesh->selectLod(model, view, lod) : 0;
+            batchParts.push_back({ model, rig[p].livery ? car.livery : rig[p].color, lod });
+        }
+        batch->draw(batchParts, view);
+    }
+}
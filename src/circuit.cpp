@@ -1,4 +1,6 @@
 #include "circuit.h"
+#include "material.h"
+#include "renderstats.h"
 #include <vector>
 
 Circuit::Circuit()
@@ -76,10 +78,25 @@ void Circuit::setupGPUBuffers() {
     glDeleteBuffers(1, &EBO); // EBO can be deleted if not needed after VAO setup
 }
 
-void Circuit::draw(Shader& shader) {
-    shader.setMat4("model", modelMatrix);
-    shader.setVec3("objectColor", color);
+void Circuit::draw(Shader& shader, const RenderView& view) {
+    // The unit square in the XZ plane, before modelMatrix
+    RenderStats& stats = frameStats();
+    if (!view.frustum.intersectsBox(glm::vec3(-0.5f, 0.0f, -0.5f), glm::vec3(0.5f, 0.0f, 0.5f), modelMatrix)) {
+        ++stats.culledObjects;
+        return;
+    }
+    ++stats.visibleObjects;
+
+    const DrawUniforms& uniforms = shader.drawUniforms();
+    shader.setMat4(uniforms.model, modelMatrix);
+    shader.setVec3(uniforms.objectColor, color);
+    shader.setVec3(uniforms.positionOffset, glm::vec3(0.0f));
+    shader.setVec3(uniforms.positionScale, glm::vec3(1.0f));
+    MaterialLibrary::instance().bind(shader, MaterialLibrary::DEFAULT_MATERIAL);
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    ++stats.vaoBinds;
+    ++stats.drawCalls;
+    stats.triangles += 2;
     glBindVertexArray(0);
 } 
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "controlscript.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+
+bool loadControlScript(const std::string& path, ControlScript& script) {
+    static const std::unordered_map<std::string, Control> controls = {
+        { "throttle", Control::Throttle }, { "brake", Control::Brake },
+        { "left", Control::Left }, { "right", Control::Right },
+    };
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open control script: " << path << std::endl;
+        return false;
+    }
+    script = ControlScript();
+    bool hasEnd = false;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::istringstream in(line);
+        std::string control, state;
+        ScriptedControl event;
+        if (!(in >> event.time)) {
+            std::string first;
+            std::istringstream check(line);
+            if (!(check >> first) || first[0] == '#') continue;
+            std::cerr << "Error: " << path << ":" << lineNumber << ": expected a time in seconds" << std::endl;
+            return false;
+        }
+        in >> control >> state;
+        if (control == "end") {
+            script.duration = event.time;
+            hasEnd = true;
+            continue;
+        }
+        auto it = controls.find(control);
+        if (it == controls.end() || (state != "on" && state != "off") || event.time < 0.0) {
+            std::cerr << "Error: " << path << ":" << lineNumber
+                      << ": expected <seconds> <throttle|brake|left|right> <on|off> or <seconds> end" << std::endl;
+            return false;
+        }
+        event.control = it->second;
+        event.on = state == "on";
+        script.events.push_back(event);
+    }
+    std::stable_sort(script.events.begin(), script.events.end(),
+                     [](const ScriptedControl& a, const ScriptedControl& b) { return a.time < b.time; });
+    if (!hasEnd && !script.events.empty()) {
+        script.duration = script.events.back().time;
+    }
+    return true;
+}
+
+const VehicleControls& ControlPlayer::advance(double time) {
+    for (; next < script.events.size() && script.events[next].time <= time; ++next) {
+        const ScriptedControl& event = script.events[next];
+        switch (event.control) {
+        case Control::Throttle: controls.throttle = event.on; break;
+        case Control::Brake: controls.brake = event.on; break;
+        case Control::Left: controls.left = event.on; break;
+        case Control::Right: controls.right = event.on; break;
+        }
+    }
+    return controls;
+}
@@ -1,26 +1,101 @@
 #include "dashboard.h"
+#include "streambuffer.h"
+#include "renderstats.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <cmath>
-#include <dashboard.h>
-#include <shader.h>
+#include <cstddef>
+#include <algorithm>
 
 #ifndef M_PI
 #define M_PI 3.1415926535
 #endif
 
-Dashboard::Dashboard(int width, int height) 
-    : windowWidth(width), windowHeight(height), 
-      shader("path/to/dashboard.vs", "path/to/dashboard.fs") // <<<--- 修改为你的着色器路径
+namespace {
+
+// 5x7 glyphs, one byte per row, bit 4 is the leftmost pixel
+struct Glyph {
+    char character;
+    uint8_t rows[7];
+};
+
+const Glyph FONT[] = {
+    { '0', { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E } },
+    { '1', { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+    { '2', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F } },
+    { '3', { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E } },
+    { '4', { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 } },
+    { '5', { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E } },
+    { '6', { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E } },
+    { '7', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+    { '8', { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E } },
+    { '9', { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C } },
+    { 'R', { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+    { 'P', { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 } },
+    { 'M', { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+    { 'K', { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } },
+    { 'H', { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+    { '/', { 0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x10 } },
+};
+
+const Glyph* findGlyph(char c) {
+    for (const Glyph& glyph : FONT) {
+        if (glyph.character == c) return &glyph;
+    }
+    return nullptr;
+}
+
+uint32_t packColor(const glm::vec4& color) {
+    glm::vec4 c = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+    return static_cast<uint32_t>(c.x) | static_cast<uint32_t>(c.y) << 8 |
+           static_cast<uint32_t>(c.z) << 16 | static_cast<uint32_t>(c.w) << 24;
+}
+
+// Point at angle (clockwise from up) on a circle; screen y grows downwards
+glm::vec2 onCircle(glm::vec2 center, float radius, float angle) {
+    return center + radius * glm::vec2(std::sin(angle), -std::cos(angle));
+}
+
+// Width of text in the 5x7 font: 5 pixels per glyph plus 1 between glyphs
+float textWidth(const std::string& text, float pixel) {
+    return text.empty() ? 0.0f : (6.0f * text.size() - 1.0f) * pixel;
+}
+
+// Gauge layout
+const float GAUGE_RADIUS = 100.0f;
+const float GAUGE_MARGIN = 30.0f;
+const float GAUGE_START = static_cast<float>(-135.0 * M_PI / 180.0);
+const float GAUGE_END = static_cast<float>(135.0 * M_PI / 180.0);
+const float MAX_RPM = 8000.0f;
+const float REDLINE_RPM = 6500.0f;
+const float MAX_SPEED = 360.0f; // km/h at a full speed bar
+
+} // namespace
+
+Dashboard::Dashboard()
+    : windowWidth(800), windowHeight(800), VAO(0)
 {
-    setupGauge();
-    setupNeedle();
 }
 
 Dashboard::~Dashboard() {
-    glDeleteVertexArrays(1, &gaugeVAO);
-    glDeleteBuffers(1, &gaugeVBO);
-    glDeleteVertexArrays(1, &needleVAO);
-    glDeleteBuffers(1, &needleVBO);
+    if (VAO != 0) {
+        glDeleteVertexArrays(1, &VAO);
+    }
+}
+
+bool Dashboard::initialize() {
+    shader = std::make_unique<Shader>("assets/shaders/dashBoard.vert", "assets/shaders/dashBoard.frag");
+    if (!shader->finish()) {
+        return false;
+    }
+    projectionUniform = shader->uniform("projection");
+    // Vertices come from the stream buffer, so the attribute pointers are set per frame
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    vertices.reserve(4096);
+    return true;
 }
 
 void Dashboard::setWindowSize(int width, int height) {
@@ -28,108 +103,138 @@ void Dashboard::setWindowSize(int width, int height) {
     windowHeight = height;
 }
 
-void Dashboard::setupGauge() {
-    // 1. 生成表盘弧线的顶点
-    float radius = 100.0f;
-    int segments = 40;
-    // 我们绘制一个从-135度到135度的弧线
-    float startAngle = -135.0f * M_PI / 180.0f;
-    float endAngle = 135.0f * M_PI / 180.0f;
-    float angleStep = (endAngle - startAngle) / segments;
-
-    for (int i = 0; i <= segments; ++i) {
-        float angle = startAngle + i * angleStep;
-        gaugeVertices.push_back(glm::vec2(radius * cos(angle), radius * sin(angle)));
-    }
-
-    // 2. 创建 VBO 和 VAO
-    glGenVertexArrays(1, &gaugeVAO);
-    glGenBuffers(1, &gaugeVBO);
-
-    glBindVertexArray(gaugeVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, gaugeVBO);
-    glBufferData(GL_ARRAY_BUFFER, gaugeVertices.size() * sizeof(glm::vec2), &gaugeVertices[0], GL_STATIC_DRAW);
+void Dashboard::addQuad(glm::vec2 a, glm::vec2 b, glm::vec2 c, glm::vec2 d, uint32_t color) {
+    vertices.push_back({ a, color });
+    vertices.push_back({ b, color });
+    vertices.push_back({ c, color });
+    vertices.push_back({ a, color });
+    vertices.push_back({ c, color });
+    vertices.push_back({ d, color });
+}
 
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
-    glEnableVertexAttribArray(0);
+void Dashboard::addRect(glm::vec2 min, glm::vec2 max, glm::vec4 color) {
+    addQuad(min, glm::vec2(max.x, min.y), max, glm::vec2(min.x, max.y), packColor(color));
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+void Dashboard::addLine(glm::vec2 from, glm::vec2 to, float width, glm::vec4 color) {
+    glm::vec2 direction = to - from;
+    float length = glm::length(direction);
+    if (length <= 0.0f) return;
+    glm::vec2 side = glm::vec2(-direction.y, direction.x) / length * (0.5f * width);
+    addQuad(from - side, to - side, to + side, from + side, packColor(color));
 }
 
-void Dashboard::setupNeedle() {
-    // 指针就是一条线，从中心点到边缘
-    float length = 95.0f;
-    glm::vec2 needleVertices[] = {
-        glm::vec2(0.0f, 0.0f),       // 中心点
-        glm::vec2(0.0f, length)      // 指针尖端 (初始朝上)
-    };
+void Dashboard::addArc(glm::vec2 center, float innerRadius, float outerRadius,
+                       float startAngle, float endAngle, glm::vec4 color) {
+    // About one segment per 6 degrees keeps the edge smooth at gauge sizes
+    int segments = std::max(1, static_cast<int>(std::ceil(std::abs(endAngle - startAngle) / 0.1f)));
+    uint32_t packed = packColor(color);
+    float step = (endAngle - startAngle) / segments;
+    for (int i = 0; i < segments; ++i) {
+        float a0 = startAngle + i * step, a1 = a0 + step;
+        addQuad(onCircle(center, innerRadius, a0), onCircle(center, outerRadius, a0),
+                onCircle(center, outerRadius, a1), onCircle(center, innerRadius, a1), packed);
+    }
+}
 
-    glGenVertexArrays(1, &needleVAO);
-    glGenBuffers(1, &needleVBO);
+void Dashboard::addText(glm::vec2 topLeft, float pixel, const std::string& text, glm::vec4 color) {
+    uint32_t packed = packColor(color);
+    glm::vec2 pen = topLeft;
+    for (char c : text) {
+        const Glyph* glyph = findGlyph(c);
+        for (int row = 0; glyph && row < 7; ++row) {
+            // One quad per horizontal run of lit pixels
+            int column = 0;
+            while (column < 5) {
+                if (!(glyph->rows[row] & (0x10 >> column))) { ++column; continue; }
+                int end = column;
+                while (end < 5 && (glyph->rows[row] & (0x10 >> end))) ++end;
+                glm::vec2 min = pen + pixel * glm::vec2(column, row);
+                glm::vec2 max = pen + pixel * glm::vec2(end, row + 1);
+                addQuad(min, glm::vec2(max.x, min.y), max, glm::vec2(min.x, max.y), packed);
+                column = end;
+            }
+        }
+        pen.x += 6.0f * pixel;
+    }
+}
 
-    glBindVertexArray(needleVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, needleVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(needleVertices), needleVertices, GL_STATIC_DRAW);
+void Dashboard::render(int rpm, float speed) {
+    const glm::vec4 panel(0.0f, 0.0f, 0.0f, 0.45f);
+    const glm::vec4 dial(0.8f, 0.8f, 0.8f, 1.0f);
+    const glm::vec4 redline(0.9f, 0.1f, 0.1f, 1.0f);
+    const glm::vec4 needle(1.0f, 0.2f, 0.1f, 1.0f);
+    const glm::vec4 text(1.0f, 1.0f, 1.0f, 1.0f);
+
+    // RPM gauge in the bottom left corner
+    glm::vec2 center(GAUGE_MARGIN + GAUGE_RADIUS, windowHeight - GAUGE_MARGIN - GAUGE_RADIUS);
+    addArc(center, 0.0f, GAUGE_RADIUS + 12.0f, 0.0f, 2.0f * static_cast<float>(M_PI), panel);
+    float redlineAngle = GAUGE_START + (REDLINE_RPM / MAX_RPM) * (GAUGE_END - GAUGE_START);
+    addArc(center, GAUGE_RADIUS - 4.0f, GAUGE_RADIUS, GAUGE_START, redlineAngle, dial);
+    addArc(center, GAUGE_RADIUS - 8.0f, GAUGE_RADIUS, redlineAngle, GAUGE_END, redline);
+    for (int tick = 0; tick <= 8; ++tick) {
+        float angle = GAUGE_START + tick / 8.0f * (GAUGE_END - GAUGE_START);
+        addLine(onCircle(center, GAUGE_RADIUS - 16.0f, angle), onCircle(center, GAUGE_RADIUS - 4.0f, angle),
+                3.0f, tick * 1000 >= REDLINE_RPM ? redline : dial);
+    }
+    float rpmRatio = glm::clamp(rpm / MAX_RPM, 0.0f, 1.0f);
+    float needleAngle = GAUGE_START + rpmRatio * (GAUGE_END - GAUGE_START);
+    addLine(center, onCircle(center, GAUGE_RADIUS - 6.0f, needleAngle), 3.0f, needle);
+    addRect(center - 5.0f, center + 5.0f, dial);
+    std::string rpmText = std::to_string(std::max(rpm, 0));
+    addText(center + glm::vec2(-0.5f * textWidth(rpmText, 3.0f), 30.0f), 3.0f, rpmText, text);
+    addText(center + glm::vec2(-0.5f * textWidth("RPM", 2.0f), 58.0f), 2.0f, "RPM", dial);
+
+    // Speed bar and readout to the right of the gauge
+    glm::vec2 barMin(center.x + GAUGE_RADIUS + 30.0f, windowHeight - GAUGE_MARGIN - 24.0f);
+    glm::vec2 barMax(barMin.x + 200.0f, barMin.y + 16.0f);
+    float speedRatio = glm::clamp(speed / MAX_SPEED, 0.0f, 1.0f);
+    addRect(barMin - 4.0f, barMax + 4.0f, panel);
+    addRect(barMin, glm::vec2(barMin.x + speedRatio * (barMax.x - barMin.x), barMax.y), dial);
+    std::string speedText = std::to_string(static_cast<int>(speed + 0.5f));
+    addText(barMin - glm::vec2(0.0f, 40.0f), 4.0f, speedText, text);
+    addText(barMin + glm::vec2(textWidth(speedText, 4.0f) + 8.0f, -26.0f), 2.0f, "KM/H", dial);
+
+    flush();
+}
 
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
-    glEnableVertexAttribArray(0);
+void Dashboard::flush() {
+    if (vertices.empty() || !shader || VAO == 0) {
+        vertices.clear();
+        return;
+    }
+    StreamAllocation upload = StreamBuffer::instance().upload(vertices.data(), vertices.size() * sizeof(OverlayVertex),
+                                                              sizeof(OverlayVertex));
+    if (!upload.valid()) {
+        vertices.clear();
+        return;
+    }
 
+    // Drawn over the scene with alpha for the translucent panels
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    shader->use();
+    shader->setMat4(projectionUniform, glm::ortho(0.0f, (float)windowWidth, (float)windowHeight, 0.0f));
+    shader->setMat4(shader->drawUniforms().model, glm::mat4(1.0f));
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, upload.buffer);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(OverlayVertex),
+                          (void*)(upload.offset + offsetof(OverlayVertex, position)));
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(OverlayVertex),
+                          (void*)(upload.offset + offsetof(OverlayVertex, color)));
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
-}
 
-void Dashboard::render(float rpm) {
-    // --- 准备工作 ---
-    // 禁用深度测试，这样2D仪表盘会绘制在3D场景之上
-    glDisable(GL_DEPTH_TEST);
-    // 激活我们的2D着色器
-    shader.use();
-
-    // --- 设置投影和视图 ---
-    // 创建一个正交投影矩阵，将屏幕坐标系 (0, width, height, 0) 映射到标准设备坐标
-    glm::mat4 projection = glm::ortho(0.0f, (float)windowWidth, (float)windowHeight, 0.0f);
-    shader.setMat4("projection", projection);
-
-    // --- 绘制表盘背景弧线 ---
-    glm::mat4 model = glm::mat4(1.0f);
-    // 将表盘移动到左下角 (例如，在(120, 700)的位置)
-    model = glm::translate(model, glm::vec3(120.0f, windowHeight - 120.0f, 0.0f));
-    shader.setMat4("model", model);
-    shader.setVec3("objectColor", 0.8f, 0.8f, 0.8f); // 灰色
-
-    glLineWidth(3.0f); // 设置线宽
-    glBindVertexArray(gaugeVAO);
-    glDrawArrays(GL_LINE_STRIP, 0, gaugeVertices.size());
-
-    // --- 绘制动态指针 ---
-    // 计算旋转角度。假设最大RPM为8000，对应270度的范围 (-135 to 135)
-    float maxRPM = 8000.0f;
-    float zeroAngle = -135.0f; // 0 RPM 对应的角度
-    float maxAngle = 135.0f;   // 8000 RPM 对应的角度
-    
-    float rpmRatio = glm::clamp(rpm / maxRPM, 0.0f, 1.0f);
-    float needleAngleDegrees = zeroAngle + rpmRatio * (maxAngle - zeroAngle);
-
-    // 指针模型默认是朝上的(90度)，所以我们需要先把它转到0度位置，再应用计算出的角度
-    float initialRotation = -90.0f;
-    
-    // 创建一个新的model矩阵用于指针
-    // 注意：这里的平移必须和表盘的平移完全一样，以确保它们在同一个中心点
-    glm::mat4 needleModel = glm::mat4(1.0f);
-    needleModel = glm::translate(needleModel, glm::vec3(120.0f, windowHeight - 120.0f, 0.0f));
-    // 旋转指针
-    needleModel = glm::rotate(needleModel, glm::radians(needleAngleDegrees + initialRotation), glm::vec3(0.0f, 0.0f, 1.0f));
-    
-    shader.setMat4("model", needleModel);
-    shader.setVec3("objectColor", 1.0f, 0.0f, 0.0f); // 红色
-
-    glLineWidth(2.0f);
-    glBindVertexArray(needleVAO);
-    glDrawArrays(GL_LINES, 0, 2);
-
-    // --- 清理状态 ---
-    glLineWidth(1.0f); // 恢复默认线宽
-    glBindVertexArray(0);
-    glEnable(GL_DEPTH_TEST); // 重新启用深度测试，为下一帧的3D渲染做准备
-}
\ No newline at end of file
+    RenderStats& stats = frameStats();
+    ++stats.vaoBinds;
+    ++stats.drawCalls;
+    stats.triangles += vertices.size() / 3;
+
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+    vertices.clear();
+}
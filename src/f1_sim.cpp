@@ -0,0 +1,107 @@
+// f1_sim: the vehicle model without a window, GL or audio. Replays a control
+// script (see controlscript.h) with fixed steps as fast as the CPU allows,
+// prints the final state and can write the trajectory as CSV.
+//
+// Usage: f1_sim <script> [options]
+//   --physics-hz N       fixed physics rate (default 240)
+//   --kinematic          the original kinematic handling instead of the tire model
+//   --speed V            start rolling at V m/s
+//   --trajectory FILE    write time, position, heading, speed and inputs as CSV
+//   --sample-every N     trajectory row every N steps (default 1)
+//   --repeat N           run the script N times and report runs per minute
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include "vehicle.h"
+#include "controlscript.h"
+#include "simrunner.h"
+#include "simthread.h"
+#include "utils.h"
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <script> [--physics-hz N] [--kinematic] [--speed V]"
+                  << " [--trajectory FILE] [--sample-every N] [--repeat N]" << std::endl;
+        return 1;
+    }
+    std::string scriptPath;
+    std::string trajectoryPath;
+    double physicsHz = SIM_RATE_HZ;
+    bool kinematic = false;
+    float startSpeed = 0.0f;
+    int sampleEvery = 1;
+    int repeat = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--physics-hz" && i + 1 < argc) {
+            physicsHz = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--kinematic") {
+            kinematic = true;
+        } else if (arg == "--speed" && i + 1 < argc) {
+            startSpeed = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--trajectory" && i + 1 < argc) {
+            trajectoryPath = argv[++i];
+        } else if (arg == "--sample-every" && i + 1 < argc) {
+            sampleEvery = std::atoi(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (scriptPath.empty() && arg[0] != '-') {
+            scriptPath = arg;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+        }
+    }
+    if (scriptPath.empty() || physicsHz <= 0.0) {
+        std::cerr << "f1_sim needs a script and a positive --physics-hz" << std::endl;
+        return 1;
+    }
+
+    ControlScript script;
+    if (!loadControlScript(scriptPath, script)) {
+        return 1;
+    }
+    VehicleParams params;
+    if (kinematic) {
+        params.model = VehicleModel::Kinematic;
+    } else {
+        loadCarTires(params);
+    }
+    VehicleState initial;
+    initial.velocity = glm::vec3(startSpeed, 0.0f, 0.0f);
+    for (int i = 0; i < TIRE_COUNT; ++i) {
+        initial.wheelSpeed[i] = startSpeed / params.tires[i].radius;
+    }
+
+    std::vector<TrajectorySample> trajectory;
+    SimResult result;
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < repeat; ++run) {
+        // Only the first run records, the others measure throughput
+        bool record = run == 0 && !trajectoryPath.empty();
+        result = runControlScript(script, initial, params, physicsHz, record ? &trajectory : nullptr, sampleEvery);
+    }
+    double elapsedMs = millisecondsSince(start);
+
+    const VehicleState& s = result.final;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << scriptPath << ": " << result.time << " s in " << result.steps << " steps at " << physicsHz << " Hz ("
+              << (kinematic ? "kinematic" : "tire") << " model)" << std::endl;
+    std::cout << "Final: position (" << s.position.x << ", " << s.position.y << ", " << s.position.z << ") m, heading "
+              << s.heading << " rad, speed " << s.speed() << " m/s (" << s.speed() * 3.6f << " km/h), steering "
+              << s.steering << " deg" << std::endl;
+    std::cout << "Distance " << result.distance << " m, top speed " << result.topSpeed * 3.6f << " km/h" << std::endl;
+    std::cout << std::setprecision(1) << "Wall time " << elapsedMs << " ms for " << repeat << " run(s): "
+              << repeat / (elapsedMs / 60000.0) << " runs per minute, "
+              << result.time * repeat / (elapsedMs / 1000.0) << "x real time" << std::endl;
+
+    if (!trajectoryPath.empty()) {
+        if (!writeTrajectoryCSV(trajectoryPath, trajectory)) {
+            return 1;
+        }
+        std::cout << "Wrote " << trajectory.size() << " samples to " << trajectoryPath << std::endl;
+    }
+    return 0;
+}
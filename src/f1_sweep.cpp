@@ -0,0 +1,180 @@
+// f1_sweep: simulates every combination of setup values (see sweep.h) on all
+// cores and prints the best setups; the full table can be written as CSV.
+//
+// Usage: f1_sweep --param name=min:max:count|name=a,b,c ... [options]
+//   --metric stop|lap    stopping distance from --speed (default) or time over --lap-distance
+//   --speed V            start speed in m/s (default 83, 300 km/h, for stop)
+//   --lap-distance M     lap metric distance in m (default 1000)
+//   --script FILE        lap metric inputs (controlscript.h); default full throttle
+//   --samples N          runs per setup, each with its own seed (default 1)
+//   --jitter S           reaction delay up to S before braking, or +-S on every cluster of script events
+//   --seed N             base seed (default 1)
+//   --threads N          worker threads (default all)
+//   --scaling            rerun the sweep on 1, 2, 4 ... --threads and report the speedup
+//   --physics-hz N       fixed physics rate (default 240)
+//   --kinematic          the original kinematic handling instead of the tire model
+//   --max-time S         simulated seconds before a run counts as not finished (default 120)
+//   --top N              rows to print (default 10)
+//   --out FILE           write every row as CSV
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include "sweep.h"
+#include "simrunner.h"
+#include "simthread.h"
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " --param name=min:max:count|name=a,b,c ... [--metric stop|lap] [--speed V]"
+              << " [--lap-distance M] [--script FILE] [--samples N] [--jitter S] [--seed N] [--threads N]"
+              << " [--scaling] [--physics-hz N] [--kinematic] [--max-time S] [--top N] [--out FILE]" << std::endl;
+    std::cerr << "Parameters:";
+    for (const std::string& name : sweepParameterNames()) std::cerr << ' ' << name;
+    std::cerr << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SweepConfig config;
+    config.rateHz = SIM_RATE_HZ;
+    config.startSpeed = -1.0f;
+    std::string scriptPath;
+    std::string outPath;
+    bool kinematic = false;
+    bool scaling = false;
+    size_t top = 10;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--param" && hasValue) {
+            SweepAxis axis;
+            if (!parseSweepAxis(argv[++i], axis)) return 1;
+            config.axes.push_back(axis);
+        } else if (arg == "--metric" && hasValue) {
+            std::string metric = argv[++i];
+            if (metric == "stop") {
+                config.metric = SweepMetric::StoppingDistance;
+            } else if (metric == "lap") {
+                config.metric = SweepMetric::LapTime;
+            } else {
+                std::cerr << "Unknown metric: " << metric << std::endl;
+                return 1;
+            }
+        } else if (arg == "--speed" && hasValue) {
+            config.startSpeed = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--lap-distance" && hasValue) {
+            config.lapDistance = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--script" && hasValue) {
+            scriptPath = argv[++i];
+        } else if (arg == "--samples" && hasValue) {
+            config.samples = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--jitter" && hasValue) {
+            config.jitter = std::max(0.0, std::strtod(argv[++i], nullptr));
+        } else if (arg == "--seed" && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && hasValue) {
+            config.threads = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--scaling") {
+            scaling = true;
+        } else if (arg == "--physics-hz" && hasValue) {
+            config.rateHz = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--kinematic") {
+            kinematic = true;
+        } else if (arg == "--max-time" && hasValue) {
+            config.maxTime = std::strtod(argv[++i], nullptr);
+        } else if (arg == "--top" && hasValue) {
+            top = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--out" && hasValue) {
+            outPath = argv[++i];
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.startSpeed < 0.0f) {
+        config.startSpeed = config.metric == SweepMetric::StoppingDistance ? 83.0f : 0.0f;
+    }
+    if (config.rateHz <= 0.0 || config.maxTime <= 0.0 || config.lapDistance <= 0.0f) {
+        std::cerr << "f1_sweep needs a positive --physics-hz, --max-time and --lap-distance" << std::endl;
+        return 1;
+    }
+    if (config.metric == SweepMetric::StoppingDistance && config.startSpeed <= SWEEP_STOP_SPEED) {
+        std::cerr << "The stop metric needs a --speed above " << SWEEP_STOP_SPEED << " m/s" << std::endl;
+        return 1;
+    }
+    if (!scriptPath.empty() && !loadControlScript(scriptPath, config.script)) {
+        return 1;
+    }
+    if (kinematic) {
+        config.base.model = VehicleModel::Kinematic;
+    } else {
+        loadCarTires(config.base);
+    }
+
+    const char* unit = config.metric == SweepMetric::StoppingDistance ? "m" : "s";
+    SweepResult result = runSweep(config);
+    std::cout << result.jobs << " runs on " << result.threads << " threads in " << std::fixed << std::setprecision(1)
+              << result.wallMs << " ms (" << result.jobs / (result.wallMs / 1000.0) << " runs/s)" << std::endl;
+
+    // Best first; setups that never finished go last
+    std::vector<size_t> order(result.rows.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        float ma = result.rows[a].mean, mb = result.rows[b].mean;
+        if (std::isnan(mb)) return !std::isnan(ma);
+        return !std::isnan(ma) && ma < mb;
+    });
+
+    std::cout << std::setprecision(3);
+    for (const SweepAxis& axis : config.axes) {
+        std::cout << std::setw(18) << axis.name;
+    }
+    std::cout << std::setw(12) << (std::string("mean ") + unit) << std::setw(10) << "min" << std::setw(10) << "max"
+              << std::setw(10) << "finished" << std::endl;
+    for (size_t i = 0; i < std::min(top, order.size()); ++i) {
+        const SweepRow& row = result.rows[order[i]];
+        for (float value : row.values) {
+            std::cout << std::setw(18) << value;
+        }
+        std::cout << std::setw(12) << row.mean << std::setw(10) << row.min << std::setw(10) << row.max
+                  << std::setw(7) << row.finished << "/" << std::max(config.samples, 1) << std::endl;
+    }
+
+    if (scaling) {
+        // Same sweep on more and more threads; the results must not change
+        unsigned maxThreads = result.threads;
+        double single = 0.0;
+        std::cout << std::setprecision(1) << "threads      ms   speedup  efficiency" << std::endl;
+        for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+            SweepConfig scaled = config;
+            scaled.threads = threads;
+            SweepResult run = runSweep(scaled);
+            if (threads == 1) single = run.wallMs;
+            for (size_t p = 0; p < run.rows.size(); ++p) {
+                float a = run.rows[p].mean, b = result.rows[p].mean;
+                if (a != b && !(std::isnan(a) && std::isnan(b))) {
+                    std::cerr << "Error: row " << p << " differs on " << threads << " threads" << std::endl;
+                    return 1;
+                }
+            }
+            std::cout << std::setw(7) << threads << std::setw(8) << run.wallMs << std::setw(9) << single / run.wallMs
+                      << "x" << std::setw(10) << 100.0 * single / run.wallMs / threads << "%" << std::endl;
+            if (threads == maxThreads) break;
+        }
+    }
+
+    if (!outPath.empty()) {
+        if (!writeSweepCSV(outPath, config, result)) {
+            return 1;
+        }
+        std::cout << "Wrote " << result.rows.size() << " rows to " << outPath << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "framebuffer.h"
+#include <iostream>
+#include <algorithm>
+
+Framebuffer::Framebuffer(int width, int height)
+    : FBO(0), colorRBO(0), depthRBO(0), width(width), height(height), complete(false)
+{
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+    glGenRenderbuffers(1, &colorRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRBO);
+
+    glGenRenderbuffers(1, &depthRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    complete = status == GL_FRAMEBUFFER_COMPLETE;
+    if (!complete) {
+        std::cerr << "Error: Offscreen framebuffer incomplete (status 0x" << std::hex << status << std::dec << ")" << std::endl;
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+Framebuffer::~Framebuffer() {
+    if (FBO != 0) {
+        glDeleteFramebuffers(1, &FBO);
+    }
+    if (colorRBO != 0) {
+        glDeleteRenderbuffers(1, &colorRBO);
+    }
+    if (depthRBO != 0) {
+        glDeleteRenderbuffers(1, &depthRBO);
+    }
+}
+
+void Framebuffer::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glViewport(0, 0, width, height);
+}
+
+std::vector<unsigned char> Framebuffer::readPixels() const {
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    std::vector<unsigned char> pixels(rowBytes * height);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    // GL rows start at the bottom
+    for (int y = 0; y < height / 2; ++y) {
+        std::swap_ranges(pixels.begin() + y * rowBytes, pixels.begin() + (y + 1) * rowBytes,
+                         pixels.begin() + (height - 1 - y) * rowBytes);
+    }
+    return pixels;
+}
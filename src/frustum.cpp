@@ -0,0 +1,106 @@
+#include "frustum.h"
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define F1_FRUSTUM_SSE 1
+#endif
+
+Frustum::Frustum() {
+    for (int i = 0; i < 8; ++i) {
+        nx[i] = ny[i] = nz[i] = 0.0f;
+        d[i] = 1.0f;
+    }
+}
+
+Frustum::Frustum(const glm::mat4& m) : Frustum() {
+    // Rows of the matrix (glm is column-major)
+    glm::vec4 row[4];
+    for (int r = 0; r < 4; ++r) {
+        row[r] = glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]);
+    }
+    const glm::vec4 planes[6] = {
+        row[3] + row[0], row[3] - row[0], // left, right
+        row[3] + row[1], row[3] - row[1], // bottom, top
+        row[3] + row[2], row[3] - row[2], // near, far
+    };
+    for (int i = 0; i < 6; ++i) {
+        float length = glm::length(glm::vec3(planes[i]));
+        float scale = length > 0.0f ? 1.0f / length : 0.0f;
+        nx[i] = planes[i].x * scale;
+        ny[i] = planes[i].y * scale;
+        nz[i] = planes[i].z * scale;
+        d[i] = planes[i].w * scale;
+    }
+}
+
+bool Frustum::intersectsBox(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& model) const {
+    // Arvo: the world box around a transformed box has extent |M| * extent
+    glm::vec3 localCenter = 0.5f * (boundsMin + boundsMax);
+    glm::vec3 localExtent = 0.5f * (boundsMax - boundsMin);
+    glm::vec3 center = glm::vec3(model * glm::vec4(localCenter, 1.0f));
+    glm::vec3 extent = glm::abs(glm::vec3(model[0])) * localExtent.x
+                     + glm::abs(glm::vec3(model[1])) * localExtent.y
+                     + glm::abs(glm::vec3(model[2])) * localExtent.z;
+    return intersectsBox(center, extent);
+}
+
+bool Frustum::intersectsBox(const glm::vec3& center, const glm::vec3& extent) const {
+    // Outside a plane when the centre's distance is below minus the box's projected radius
+#ifdef F1_FRUSTUM_SSE
+    const __m128 cx = _mm_set1_ps(center.x), cy = _mm_set1_ps(center.y), cz = _mm_set1_ps(center.z);
+    const __m128 ex = _mm_set1_ps(extent.x), ey = _mm_set1_ps(extent.y), ez = _mm_set1_ps(extent.z);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    for (int i = 0; i < 8; i += 4) {
+        __m128 px = _mm_load_ps(nx + i), py = _mm_load_ps(ny + i), pz = _mm_load_ps(nz + i);
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, cx), _mm_mul_ps(py, cy)),
+                                     _mm_add_ps(_mm_mul_ps(pz, cz), _mm_load_ps(d + i)));
+        __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, px), ex),
+                                              _mm_mul_ps(_mm_andnot_ps(signMask, py), ey)),
+                                   _mm_mul_ps(_mm_andnot_ps(signMask, pz), ez));
+        if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps())) != 0) {
+            return false;
+        }
+    }
+    return true;
+#else
+    for (int i = 0; i < 6; ++i) {
+        float distance = nx[i] * center.x + ny[i] * center.y + nz[i] * center.z + d[i];
+        float radius = std::abs(nx[i]) * extent.x + std::abs(ny[i]) * extent.y + std::abs(nz[i]) * extent.z;
+        if (distance + radius < 0.0f) return false;
+    }
+    return true;
+#endif
+}
+
+void Frustum::intersectSpheres(const glm::vec4* spheres, size_t count, uint8_t* visible) const {
+    size_t i = 0;
+#ifdef F1_FRUSTUM_SSE
+    // Four spheres at a time against one plane per step
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(&spheres[i].x);
+        __m128 y = _mm_loadu_ps(&spheres[i + 1].x);
+        __m128 z = _mm_loadu_ps(&spheres[i + 2].x);
+        __m128 r = _mm_loadu_ps(&spheres[i + 3].x);
+        _MM_TRANSPOSE4_PS(x, y, z, r);
+        __m128 outside = _mm_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(nx[p]), x), _mm_mul_ps(_mm_set1_ps(ny[p]), y)),
+                                         _mm_add_ps(_mm_mul_ps(_mm_set1_ps(nz[p]), z), _mm_set1_ps(d[p])));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, r), _mm_setzero_ps()));
+        }
+        int mask = _mm_movemask_ps(outside);
+        for (int lane = 0; lane < 4; ++lane) {
+            visible[i + lane] = (mask >> lane) & 1 ? 0 : 1;
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        const glm::vec4& s = spheres[i];
+        bool inside = true;
+        for (int p = 0; p < 6 && inside; ++p) {
+            inside = nx[p] * s.x + ny[p] * s.y + nz[p] * s.z + d[p] + s.w >= 0.0f;
+        }
+        visible[i] = inside ? 1 : 0;
+    }
+}
@@ -0,0 +1,49 @@
+#include "inputscript.h"
+#include <GLFW/glfw3.h>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <unordered_map>
+
+bool loadInputScript(const std::string& path, std::vector<ScriptedKey>& events) {
+    static const std::unordered_map<std::string, int> keys = {
+        { "UP", GLFW_KEY_UP }, { "DOWN", GLFW_KEY_DOWN }, { "LEFT", GLFW_KEY_LEFT }, { "RIGHT", GLFW_KEY_RIGHT },
+        { "W", GLFW_KEY_W }, { "A", GLFW_KEY_A }, { "S", GLFW_KEY_S }, { "D", GLFW_KEY_D },
+        { "Q", GLFW_KEY_Q }, { "E", GLFW_KEY_E }, { "C", GLFW_KEY_C },
+    };
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open input script: " << path << std::endl;
+        return false;
+    }
+    events.clear();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::istringstream in(line);
+        std::string key, action;
+        ScriptedKey event;
+        if (!(in >> event.frame)) {
+            std::string first;
+            std::istringstream check(line);
+            if (!(check >> first) || first[0] == '#') continue;
+            std::cerr << "Error: " << path << ":" << lineNumber << ": expected a frame number" << std::endl;
+            return false;
+        }
+        in >> key >> action;
+        auto it = keys.find(key);
+        if (it == keys.end() || (action != "press" && action != "release")) {
+            std::cerr << "Error: " << path << ":" << lineNumber << ": expected <frame> <key> <press|release>" << std::endl;
+            return false;
+        }
+        event.key = it->second;
+        event.action = action == "press" ? GLFW_PRESS : GLFW_RELEASE;
+        events.push_back(event);
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const ScriptedKey& a, const ScriptedKey& b) { return a.frame < b.frame; });
+    return true;
+}
@@ -2,6 +2,16 @@
 #include <iostream>
 #include <vector>
 #include <cmath> // For sin and cos
+#include <chrono>
+#include <thread>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
 
 // GLEW
 #include <GL/glew.h> 
@@ -16,7 +26,20 @@
 #include "car.h"
 #include "shader.h"
 #include "circuit.h"
-// #include "dashboard.h"
+#include "utils.h"
+#include "material.h"
+#include "renderstats.h"
+#include "uniformbuffer.h"
+#include "streambuffer.h"
+#include "meshbatch.h"
+#include "carfleet.h"
+#include "framebuffer.h"
+#include "inputscript.h"
+#include "image.h"
+#include "profiler.h"
+#include "programcache.h"
+#include "dashboard.h"
+#include "simthread.h"
 
 // Window dimensions (initial values)
 GLint WIDTH = 800, HEIGHT = 800;
@@ -35,7 +58,7 @@ int cameraMode = 0;
 // Create a Car object
 Car myCar;
 Circuit ground;
-// Dashboard dashboard;
+Dashboard dashboard;
 
 // Movement speed for camera and ball
 float cameraSpeed = 2.5f; // Units per second
@@ -45,6 +68,10 @@ float ballSpeed = 1.5f;   // Units per second
 float deltaTime = 0.0f; // Time between current frame and last frame
 float lastFrame = 0.0f; // Time of last frame
 
+// --headless: offscreen rendering with a fixed time step
+bool headless = false;
+const float HEADLESS_TIME_STEP = 1.0f / 60.0f;
+
 
 /**
  * @brief Keyboard input callback function.
@@ -56,6 +83,15 @@ float lastFrame = 0.0f; // Time of last frame
  * @param mods Bit field describing which modifier keys were held down.
  */
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    // Profiler (--profile): F11 prints the rolling zone stats, F12 writes a Chrome trace
+    if (action == GLFW_PRESS && Profiler::instance().isEnabled()) {
+        static int traceCount = 0;
+        if (key == GLFW_KEY_F11)
+            Profiler::instance().printStats();
+        if (key == GLFW_KEY_F12)
+            Profiler::instance().writeChromeTrace("trace_" + std::to_string(traceCount++) + ".json");
+    }
+
     // Only process key presses and repeats
     if (action == GLFW_PRESS || GLFW_REPEAT) {
         // Camera controls (W, S, A, D, Q, E)
@@ -123,11 +159,190 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
     WIDTH = width; // Update global WIDTH
     HEIGHT = height; // Update global HEIGHT
-    // dashboard.setWindowSize(WIDTH, HEIGHT);
+    dashboard.setWindowSize(WIDTH, HEIGHT);
+}
+
+// Shows the finished frame. Headless runs have nothing to swap; they wait for the GPU
+// instead so frame times still include rendering.
+void presentFrame(GLFWwindow* window) {
+    ProfileZone zone("swap");
+    if (headless) {
+        glFinish();
+    } else {
+        glfwSwapBuffers(window);
+    }
+}
+
+// Starting grid for fleet rendering: car 0 follows the player, the rest sit in
+// two staggered columns behind the origin with animated steering and wheels
+void buildGrid(std::vector<FleetCar>& cars, const Car& leader, int count, float time) {
+    static const glm::vec3 liveries[] = {
+        { 0.86f, 0.0f, 0.0f }, { 0.0f, 0.82f, 0.75f }, { 0.02f, 0.12f, 0.45f }, { 1.0f, 0.53f, 0.0f },
+        { 0.0f, 0.44f, 0.35f }, { 0.0f, 0.35f, 1.0f }, { 1.0f, 1.0f, 1.0f }, { 0.4f, 0.5f, 1.0f },
+        { 0.32f, 0.9f, 0.32f }, { 0.1f, 0.1f, 0.1f },
+    };
+    cars.resize(count);
+    if (count == 0) return;
+    cars[0] = leader.fleetState();
+    for (int i = 1; i < count; ++i) {
+        int row = i / 2, column = i % 2;
+        glm::vec3 slot(-8.0f * row - 4.0f * column, 0.0f, column ? -2.5f : 2.5f);
+        cars[i].model = glm::translate(glm::mat4(1.0f), slot);
+        cars[i].livery = liveries[i % (sizeof(liveries) / sizeof(liveries[0]))];
+        cars[i].steering = 0.3f * std::sin(time + i);
+        cars[i].wheelSpin = 20.0f * time;
+    }
+}
+
+// Renders the grid at increasing sizes, instanced and with one batch draw per car,
+// and prints the median CPU submit time and frame time (including glFinish) for each
+void runFleetBenchmark(GLFWwindow* window, CarFleet& fleet, Shader& fleetShader, Shader& batchShader,
+                       const FrameData& frameData, const RenderView& renderView) {
+    const int counts[] = { 1, 2, 5, 10, 20, 50, 100, 200 };
+    const int warmupFrames = 10, measuredFrames = 100;
+    const char* modes[] = { "instanced", "per-car batch" };
+    if (!headless) {
+        glfwSwapInterval(0);
+    }
+
+    std::cout << "Fleet benchmark (" << measuredFrames << " frames per run, medians)" << std::endl;
+    std::vector<FleetCar> cars;
+    for (int count : counts) {
+        for (int mode = 0; mode < 2; ++mode) {
+            std::vector<double> submitMs, frameMs;
+            unsigned long drawCalls = 0, culled = 0;
+            for (int frame = 0; frame < warmupFrames + measuredFrames; ++frame) {
+                auto frameBegin = std::chrono::steady_clock::now();
+                StreamBuffer::instance().beginFrame();
+                frameStats().reset();
+                MaterialLibrary::instance().resetBindings();
+                glfwPollEvents();
+                buildGrid(cars, myCar, count, frame / 60.0f);
+
+                glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                StreamBuffer::instance().uploadUniforms(FRAME_DATA_BINDING, &frameData, sizeof(frameData));
+
+                auto submitBegin = std::chrono::steady_clock::now();
+                if (mode == 0) {
+                    fleetShader.use();
+                    fleet.draw(fleetShader, cars, renderView);
+                } else {
+                    batchShader.use();
+                    fleet.drawPerCar(cars, renderView);
+                }
+                double submit = millisecondsSince(submitBegin);
+
+                StreamBuffer::instance().endFrame();
+                presentFrame(window);
+                glFinish();
+                if (frame >= warmupFrames) {
+                    submitMs.push_back(submit);
+                    frameMs.push_back(millisecondsSince(frameBegin));
+                    drawCalls = frameStats().drawCalls;
+                    culled = frameStats().culledObjects;
+                }
+            }
+            std::cout << "  " << count << " cars, " << modes[mode] << ": submit " << median(submitMs)
+                      << " ms, frame " << median(frameMs) << " ms, " << drawCalls << " draw calls, "
+                      << culled << " culled" << std::endl;
+        }
+    }
 }
 
-int main() {
+/**
+ * Command-line options:
+ *   --packed-vertices  upload car meshes in the 16-byte interleaved format
+ *   --no-multi-draw    draw the car batch with a draw loop instead of glMultiDrawElementsIndirect
+ *   --fleet N          draw a grid of N cars with instancing (car 0 is the player)
+ *   --fleet-bench      time the grid at 1..200 cars, instanced vs. one batch per car, then exit
+ *   --frames N         exit after N frames (for frame-time comparisons, e.g.
+ *                      LIBGL_ALWAYS_SOFTWARE=1 F1 --frames 600 [--packed-vertices])
+ *   --headless         no window or display: render into an offscreen framebuffer with a
+ *                      fixed 1/60 s time step (default 600 frames, or to the end of the script)
+ *   --script FILE      replay key events from FILE (see inputscript.h)
+ *   --dump-frames LIST save the listed frames (comma separated, from 0) as PNGs
+ *   --dump-dir DIR     where --dump-frames writes (default "frames")
+ *   --profile          time CPU zones and GPU passes; F11 prints avg/p95/p99 per zone,
+ *                      F12 writes trace_N.json (chrome://tracing); stats are printed at exit
+ *   --trace FILE       with --profile, also write a Chrome trace of the last frames at exit
+ *   --no-shader-cache  always compile shaders from source (see programcache.h)
+ *   --physics-hz N     fixed physics rate (default 240); rendering interpolates between steps
+ *   --kinematic        drive with the original kinematic handling instead of the tire model
+ *   --no-sim-thread    step the car from the render loop, with the frame time, instead of on
+ *                      the simulation thread (always the case with --headless)
+ */
+int main(int argc, char** argv) {
+    long frameLimit = 0;
+    int fleetSize = 0;
+    bool fleetBench = false;
+    std::vector<ScriptedKey> script;
+    std::set<long> dumpFrames;
+    std::string dumpDir = "frames";
+    bool profile = false;
+    std::string tracePath;
+    bool simThread = true;
+    double physicsHz = SIM_RATE_HZ;
+    bool kinematic = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--packed-vertices") {
+            Mesh::setDefaultVertexFormat(VertexFormat::Packed);
+        } else if (arg == "--no-multi-draw") {
+            MeshBatch::setMultiDrawEnabled(false);
+        } else if (arg == "--fleet" && i + 1 < argc) {
+            fleetSize = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--fleet-bench") {
+            fleetBench = true;
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frameLimit = std::strtol(argv[++i], nullptr, 10);
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--script" && i + 1 < argc) {
+            if (!loadInputScript(argv[++i], script)) {
+                return -1;
+            }
+        } else if (arg == "--dump-frames" && i + 1 < argc) {
+            std::istringstream list(argv[++i]);
+            std::string frame;
+            while (std::getline(list, frame, ',')) {
+                dumpFrames.insert(std::strtol(frame.c_str(), nullptr, 10));
+            }
+        } else if (arg == "--dump-dir" && i + 1 < argc) {
+            dumpDir = argv[++i];
+        } else if (arg == "--no-shader-cache") {
+            setProgramCacheEnabled(false);
+        } else if (arg == "--physics-hz" && i + 1 < argc) {
+            physicsHz = std::strtod(argv[++i], nullptr);
+            if (physicsHz <= 0.0) {
+                std::cerr << "--physics-hz needs a positive rate" << std::endl;
+                return -1;
+            }
+        } else if (arg == "--kinematic") {
+            kinematic = true;
+        } else if (arg == "--no-sim-thread") {
+            simThread = false;
+        } else if (arg == "--profile") {
+            profile = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            profile = true;
+            tracePath = argv[++i];
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+        }
+    }
+
+    if (headless && frameLimit <= 0) {
+        frameLimit = script.empty() ? 600 : script.back().frame + 1;
+    }
+
     // 1. Initialize GLFW
+#ifdef GLFW_PLATFORM_NULL
+    // Headless runs need no display server (GLFW 3.4+); older GLFW falls back to a hidden window
+    if (headless) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+#endif
     if (!glfwInit()) {
         std::cout << "GLFW initialization failed!" << std::endl;
         glfwTerminate();
@@ -146,7 +361,22 @@ int main() {
     glfwWindowHint(GLFW_RESIZABLE, GL_TRUE); // Changed to GL_TRUE
 
     // 3. Create GLFW window object
-    GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Formula 1", nullptr, nullptr);
+    GLFWwindow* window = nullptr;
+    if (headless) {
+        // EGL (surfaceless on the null platform), else OSMesa (llvmpipe)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        const int contextApis[] = { GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API };
+        const char* contextNames[] = { "EGL", "OSMesa" };
+        for (int i = 0; i < 2 && !window; ++i) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApis[i]);
+            window = glfwCreateWindow(WIDTH, HEIGHT, "Formula 1", nullptr, nullptr);
+            if (window) {
+                std::cout << "Headless " << contextNames[i] << " context created" << std::endl;
+            }
+        }
+    } else {
+        window = glfwCreateWindow(WIDTH, HEIGHT, "Formula 1", nullptr, nullptr);
+    }
     if (!window) {
         std::cout << "Failed to create GLFW window" << std::endl;
         glfwTerminate();
@@ -162,21 +392,41 @@ int main() {
 
     // Initialize GLEW
     glewExperimental = GL_TRUE; // Required for core profile functionality
-    if (glewInit() != GLEW_OK) {
+    GLenum glewStatus = glewInit();
+    // A GLX build of GLEW reports "no GLX display" on EGL contexts but has still loaded every entry point
+    if (glewStatus != GLEW_OK && !(headless && glewStatus == GLEW_ERROR_NO_GLX_DISPLAY)) {
         std::cout << "GLEW initialization failed!" << std::endl;
         glfwDestroyWindow(window);
         glfwTerminate();
         return -1;
     }
 
+    // Timer queries need the GL entry points, so the profiler starts after GLEW
+    Profiler::instance().setEnabled(profile);
+
     // Enable depth testing for correct 3D rendering (objects closer obscure those farther)
     glEnable(GL_DEPTH_TEST);
 
     // Define the rendering area within the window
     glViewport(0, 0, WIDTH, HEIGHT);
+
+    // Headless frames go to an offscreen framebuffer that stays bound for the whole run
+    std::unique_ptr<Framebuffer> offscreen;
+    if (headless) {
+        offscreen = std::make_unique<Framebuffer>(WIDTH, HEIGHT);
+        if (!offscreen->isComplete()) {
+            glfwTerminate();
+            return -1;
+        }
+        offscreen->bind();
+        if (!dumpFrames.empty()) {
+            std::filesystem::create_directories(dumpDir);
+        }
+    }
     
     // Setup dashboard
-    // dashboard.setWindowSize(WIDTH, HEIGHT);
+    dashboard.initialize();
+    dashboard.setWindowSize(WIDTH, HEIGHT);
 
     // Initial model matrix for the static sphere (Sphere 1)
     glm::mat4 model1 = glm::mat4(1.0f); 
@@ -186,21 +436,52 @@ int main() {
     glm::mat4 modelCube = glm::mat4(1.0f);
     modelCube = glm::translate(modelCube, glm::vec3(1.0f, 0.0f, 0.0f)); // Position cube to the right
 
-    // load the customized shader
-    Shader carshader("assets/shaders/carShader.vert", "assets/shaders/carShader.frag");
-
-    // Load an OBJ model (replace with your actual .obj file)
+    // Startup timing breakdown
+    auto startupBegin = std::chrono::steady_clock::now();
 
-    ground.setupGPUBuffers();
-
-    if (myCar.loadModel()) {
-        myCar.setupGPUBuffers(); // Setup GPU buffers after loading
-    } else {
+    // load the customized shader; compiles continue in the driver while the models load
+    auto stageBegin = std::chrono::steady_clock::now();
+    Shader carshader("assets/shaders/carShader.vert", "assets/shaders/carShader.frag");
+    Shader batchShader("assets/shaders/carBatch.vert", "assets/shaders/carBatch.frag");
+    Shader fleetShader("assets/shaders/carFleet.vert", "assets/shaders/carFleet.frag");
+    StreamBuffer::instance().initialize();
+    double shaderMs = millisecondsSince(stageBegin);
+
+    // Load the OBJ models (parsed in parallel on worker threads)
+    stageBegin = std::chrono::steady_clock::now();
+    bool carLoaded = myCar.loadModel();
+    double parseMs = millisecondsSince(stageBegin);
+    if (!carLoaded) {
         std::cerr << "Failed to load car model." << std::endl;
         // Handle error, maybe use a fallback primitive
         return -1;
     }
 
+    // GL uploads must stay on the context thread
+    stageBegin = std::chrono::steady_clock::now();
+    ground.setupGPUBuffers();
+    myCar.setupGPUBuffers(); // Setup GPU buffers after loading
+    CarFleet fleet;
+    if (fleetSize > 0 || fleetBench) {
+        fleet.build(myCar.partMeshes(), myCar.partRig());
+    }
+    glFinish();
+    double uploadMs = millisecondsSince(stageBegin);
+
+    stageBegin = std::chrono::steady_clock::now();
+    Shader* shaders[] = { &carshader, &batchShader, &fleetShader };
+    int cachedPrograms = 0;
+    for (Shader* shader : shaders) {
+        shader->finish();
+        cachedPrograms += shader->isFromCache() ? 1 : 0;
+    }
+    double linkMs = millisecondsSince(stageBegin);
+
+    std::cout << "Startup: shader submit " << shaderMs << " ms (" << cachedPrograms << "/3 programs from cache), mesh parse "
+              << parseMs << " ms (" << std::thread::hardware_concurrency() << " hardware threads), GPU upload "
+              << uploadMs << " ms, shader link wait " << linkMs << " ms, total "
+              << millisecondsSince(startupBegin) << " ms" << std::endl;
+
     // TODO: Set texture (implement texture loading properly)
     // myCar.setTexture("path/to/your/car_texture.png");
 
@@ -210,19 +491,75 @@ int main() {
     glm::vec3 lightPos(0.0f, 20.0f, 0.0f); // 你的光源位置
     glm::vec3 lightColor(1.0f, 1.0f, 1.0f); // 光源颜色
 
+    if (fleetBench) {
+        // Fixed camera above and behind the grid
+        glm::vec3 benchCamera(30.0f, 25.0f, 30.0f);
+        glm::mat4 view = glm::lookAt(benchCamera, glm::vec3(-30.0f, 0.0f, 0.0f), cameraUp);
+        glm::mat4 projection = glm::perspective(glm::radians(50.0f), (float)WIDTH / (float)HEIGHT, 0.1f, 200.0f);
+        FrameData frameData{ view, projection, glm::vec4(lightPos, 1.0f), glm::vec4(lightColor, 1.0f), glm::vec4(benchCamera, 1.0f) };
+        RenderView renderView{ view, projection, benchCamera, static_cast<float>(HEIGHT), Frustum(projection * view) };
+        runFleetBenchmark(window, fleet, fleetShader, batchShader, frameData, renderView);
+        StreamBuffer::instance().shutdown();
+        glfwTerminate();
+        return 0;
+    }
+
+    // The car's dynamics and engine audio run in fixed steps on their own thread from here on;
+    // headless runs feed them the fixed frame time instead so output stays reproducible
+    VehicleParams vehicleParams = myCar.getParams(); // tires from the tire.ini files
+    if (kinematic) {
+        vehicleParams.model = VehicleModel::Kinematic;
+    }
+    SimThread simulation(myCar.getState(), vehicleParams, &myCar.getAudio(), physicsHz);
+    if (simThread && !headless) {
+        simulation.start();
+    }
+
     double lastFrameTime = glfwGetTime();
+    // Frame times are only kept for runs with a frame limit (benchmarks, headless),
+    // so an open-ended interactive session doesn't grow them forever
+    std::vector<double> frameTimes;
+    long frameCount = 0;
+    std::vector<FleetCar> fleetCars;
+    RenderStats totalStats;
+    if (frameLimit > 0) {
+        frameTimes.reserve(frameLimit);
+    }
+    if (frameLimit > 0 && !headless) {
+        glfwSwapInterval(0); // Unthrottled so frame times reflect rendering cost
+    }
 
     // Game loop
+    size_t nextScripted = 0;
     while (!glfwWindowShouldClose(window)) {
+        long frameIndex = frameCount;
+        if (frameLimit > 0 && frameIndex >= frameLimit) break;
+        auto frameBegin = std::chrono::steady_clock::now();
+        Profiler::instance().beginFrame();
+        StreamBuffer::instance().beginFrame();
+        frameStats().reset();
+        MaterialLibrary::instance().resetBindings();
+
         // Calculate deltaTime for frame-rate independent movement
-        float currentFrame = glfwGetTime();
+        // (simulated time when headless, so runs are reproducible)
+        float currentFrame = headless ? (frameIndex + 1) * HEADLESS_TIME_STEP : static_cast<float>(glfwGetTime());
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
         // Check and process events (e.g., keyboard input)
-        glfwPollEvents();
+        {
+            ProfileZone zone("input");
+            glfwPollEvents();
+            for (; nextScripted < script.size() && script[nextScripted].frame <= frameIndex; ++nextScripted) {
+                key_callback(window, script[nextScripted].key, 0, script[nextScripted].action, 0);
+            }
+        }
 
-        myCar.update(deltaTime);
+        simulation.setControls(myCar.getControls());
+        if (!simulation.isRunning()) {
+            simulation.advance(deltaTime);
+        }
+        myCar.applyState(simulation.sample());
 
         // Clear the color buffer with a dark teal background
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f); 
@@ -248,29 +585,86 @@ int main() {
         }
         
         glm::mat4 view = glm::lookAt(cameraPos, viewTarget, cameraUp);
+        RenderView renderView{ view, projection, cameraPos, static_cast<float>(HEIGHT), Frustum(projection * view) };
 
         glBindVertexArray(0); // Unbind VAO to prevent accidental modification from the last frame
 
+        FrameData frameData{ view, projection, glm::vec4(lightPos, 1.0f), glm::vec4(lightColor, 1.0f), glm::vec4(cameraPos, 1.0f) };
+        StreamBuffer::instance().uploadUniforms(FRAME_DATA_BINDING, &frameData, sizeof(frameData));
+
         carshader.use();
-        carshader.setMat4("view", view);
-        carshader.setMat4("projection", projection);
-        carshader.setVec3("lightPos", lightPos);
-        carshader.setVec3("lightColor", lightColor);
         
         // printMat4(view);
-        ground.draw(carshader);
-        myCar.draw(carshader);
+        {
+            ProfileZone zone("draw ground", ProfileZone::Gpu);
+            ground.draw(carshader, renderView);
+        }
+        if (fleetSize > 0) {
+            ProfileZone zone("draw fleet", ProfileZone::Gpu);
+            buildGrid(fleetCars, myCar, fleetSize, currentFrame);
+            fleetShader.use();
+            fleet.draw(fleetShader, fleetCars, renderView);
+        } else {
+            ProfileZone zone("draw car", ProfileZone::Gpu);
+            batchShader.use();
+            myCar.draw(renderView);
+        }
 
         // Render dashboard with current RPM and speed
         int rpm = static_cast<int>(glm::length(myCar.getVelocity()) * 20);
         float speed = glm::length(myCar.getVelocity()) * 3.6f; // Convert m/s to km/h
-        // dashboard.render(rpm, speed);
+        {
+            ProfileZone zone("draw dashboard", ProfileZone::Gpu);
+            dashboard.render(rpm, speed);
+        }
 
         // Swap front and back buffers (double buffering)
-        glfwSwapBuffers(window);
+        StreamBuffer::instance().endFrame();
+        presentFrame(window);
+        Profiler::instance().endFrame();
+        if (frameLimit > 0) {
+            frameTimes.push_back(millisecondsSince(frameBegin));
+        }
+        totalStats += frameStats();
+        ++frameCount;
+
+        if (headless && dumpFrames.count(frameIndex)) {
+            std::ostringstream name;
+            name << "frame_" << std::setw(5) << std::setfill('0') << frameIndex << ".png";
+            std::string path = (std::filesystem::path(dumpDir) / name.str()).string();
+            if (writePNG(path, offscreen->getWidth(), offscreen->getHeight(), offscreen->readPixels())) {
+                std::cout << ("Saved " + path + "\n") << std::flush;
+            }
+        }
         // while (true) {};   
     }
 
+    simulation.stop();
+    std::cout << "Physics: " << simulation.steps() << " steps of " << simulation.stepSeconds() * 1000.0 << " ms, "
+              << simulation.droppedSeconds() << " s dropped by the catch-up cap" << std::endl;
+
+    bool packed = Mesh::getDefaultVertexFormat() == VertexFormat::Packed;
+    printFrameTimeSummary(packed ? "Frame time (packed vertices)" : "Frame time (float vertices)", frameTimes);
+    if (frameCount > 0) {
+        double frames = static_cast<double>(frameCount);
+        std::cout << "Per frame: " << totalStats.drawCalls / frames << " draw calls, "
+                  << totalStats.triangles / frames << " triangles, "
+                  << totalStats.vaoBinds / frames << " VAO binds, "
+                  << totalStats.materialBinds / frames << " material binds, "
+                  << totalStats.textureBinds / frames << " texture binds, "
+                  << totalStats.visibleObjects / frames << " visible / "
+                  << totalStats.culledObjects / frames << " culled objects" << std::endl;
+    }
+    if (profile) {
+        Profiler::instance().printStats();
+        if (!tracePath.empty()) {
+            Profiler::instance().writeChromeTrace(tracePath);
+        }
+    }
+
+    std::cout << "Stream buffer: peak " << StreamBuffer::instance().peakBytes() / 1024.0 << " KB per frame, "
+              << StreamBuffer::instance().fenceWaits() << " fence waits" << std::endl;
+    StreamBuffer::instance().shutdown();
     glfwTerminate(); // Terminate GLFW
     return 0;
 }
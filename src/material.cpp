@@ -0,0 +1,132 @@
+#include "material.h"
+#include "shader.h"
+#include "renderstats.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+namespace {
+
+Material defaultMaterial(const std::string& name) {
+    Material material;
+    material.name = name;
+    material.diffuse = glm::vec3(1.0f);
+    material.specular = glm::vec3(0.0f);
+    material.emissive = glm::vec3(0.0f);
+    material.shininess = 0.0f;
+    material.opacity = 1.0f;
+    material.texture = 0;
+    return material;
+}
+
+glm::vec3 readColor(std::istringstream& in) {
+    glm::vec3 color(0.0f);
+    in >> color.x >> color.y >> color.z;
+    return color;
+}
+
+} // namespace
+
+MaterialLibrary& MaterialLibrary::instance() {
+    static MaterialLibrary library;
+    return library;
+}
+
+MaterialLibrary::MaterialLibrary()
+    : boundProgram(0), boundMaterial(DEFAULT_MATERIAL), boundTexture(0)
+{
+    materials.push_back(defaultMaterial("(default)"));
+}
+
+bool MaterialLibrary::loadLibrary(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Could not open MTL file: " << path << std::endl;
+        libraries[path]; // don't retry for every mesh that references it
+        return false;
+    }
+
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    auto& names = libraries[path];
+    Material* current = nullptr;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream in(line);
+        std::string keyword;
+        in >> keyword;
+        if (keyword == "newmtl") {
+            std::string name;
+            std::getline(in >> std::ws, name);
+            if (!name.empty() && name.back() == '\r') name.pop_back();
+            names[name] = static_cast<unsigned int>(materials.size());
+            materials.push_back(defaultMaterial(name));
+            current = &materials.back();
+        }
+        else if (current == nullptr) {
+            continue;
+        }
+        else if (keyword == "Kd") current->diffuse = readColor(in);
+        else if (keyword == "Ks") current->specular = readColor(in);
+        else if (keyword == "Ke") current->emissive = readColor(in);
+        else if (keyword == "Ns") in >> current->shininess;
+        else if (keyword == "d") in >> current->opacity;
+        else if (keyword == "map_Kd") {
+            // Options such as -s or -bm come first; the file name is the last token
+            std::string token, map;
+            while (in >> token) map = token;
+            if (!map.empty()) current->diffuseMap = (directory / map).string();
+        }
+    }
+    std::cout << ("MTL file loaded: " + path + ". Materials: " + std::to_string(names.size()) + "\n") << std::flush;
+    return true;
+}
+
+unsigned int MaterialLibrary::resolve(const std::vector<std::string>& libraryPaths, const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const std::string& path : libraryPaths) {
+        auto library = libraries.find(path);
+        if (library == libraries.end()) {
+            loadLibrary(path);
+            library = libraries.find(path);
+        }
+        auto it = library->second.find(name);
+        if (it != library->second.end()) {
+            return it->second;
+        }
+    }
+    if (!name.empty()) {
+        std::cerr << "Warning: Material " << name << " not found, using the default" << std::endl;
+    }
+    return DEFAULT_MATERIAL;
+}
+
+const Material& MaterialLibrary::get(unsigned int id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return id < materials.size() ? materials[id] : materials[DEFAULT_MATERIAL];
+}
+
+void MaterialLibrary::bind(Shader& shader, unsigned int id) {
+    if (shader.ID == boundProgram && id == boundMaterial) {
+        return;
+    }
+    const Material& material = get(id);
+    const DrawUniforms& uniforms = shader.drawUniforms();
+    shader.setVec3(uniforms.materialDiffuse, material.diffuse);
+    shader.setVec3(uniforms.materialEmissive, material.emissive);
+    boundProgram = shader.ID;
+    boundMaterial = id;
+    ++frameStats().materialBinds;
+
+    if (material.texture != boundTexture) {
+        glBindTexture(GL_TEXTURE_2D, material.texture);
+        boundTexture = material.texture;
+        ++frameStats().textureBinds;
+    }
+}
+
+void MaterialLibrary::resetBindings() {
+    boundProgram = 0;
+    boundMaterial = DEFAULT_MATERIAL;
+    boundTexture = 0;
+}
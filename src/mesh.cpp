@@ -0,0 +1,137 @@
+#include "mesh.h"
+#include "material.h"
+#include "renderstats.h"
+#include <algorithm>
+
+namespace {
+
+VertexFormat defaultVertexFormat = VertexFormat::Float;
+
+} // namespace
+
+RenderStats& frameStats() {
+    static RenderStats stats;
+    return stats;
+}
+
+Mesh::Mesh(const std::string& path)
+    : path(path),
+      boundsMin(0.0f), boundsMax(0.0f)
+{
+}
+
+void Mesh::setDefaultVertexFormat(VertexFormat format) {
+    defaultVertexFormat = format;
+}
+
+VertexFormat Mesh::getDefaultVertexFormat() {
+    return defaultVertexFormat;
+}
+
+void Mesh::computeBounds() {
+    if (data.vertices.empty()) return;
+    boundsMin = boundsMax = data.vertices[0];
+    for (const glm::vec3& v : data.vertices) {
+        boundsMin = glm::min(boundsMin, v);
+        boundsMax = glm::max(boundsMax, v);
+    }
+}
+
+void Mesh::resolveMaterials() {
+    MaterialLibrary& library = MaterialLibrary::instance();
+    materialIds.clear();
+    for (const std::string& name : data.materialNames) {
+        materialIds.push_back(library.resolve(data.materialLibs, name));
+    }
+    for (const MeshLod& lod : data.lods) {
+        auto first = data.submeshes.begin() + lod.firstSubmesh;
+        std::stable_sort(first, first + lod.submeshCount, [this](const MeshSubmesh& a, const MeshSubmesh& b) {
+            return submeshMaterial(a) < submeshMaterial(b);
+        });
+    }
+}
+
+unsigned int Mesh::submeshMaterial(const MeshSubmesh& submesh) const {
+    return submesh.material < materialIds.size() ? materialIds[submesh.material] : MaterialLibrary::DEFAULT_MATERIAL;
+}
+
+Mesh::~Mesh() = default;
+
+int Mesh::selectLod(const glm::mat4& model, const RenderView& view, int currentLod) const {
+    if (data.lods.size() <= 1) return 0;
+
+    // Bounding sphere in world space; scale by the largest axis so errors are never underestimated
+    float scale = glm::max(glm::length(glm::vec3(model[0])),
+                           glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+    glm::vec3 center = glm::vec3(model * glm::vec4(0.5f * (boundsMin + boundsMax), 1.0f));
+    float radius = 0.5f * glm::length(boundsMax - boundsMin) * scale;
+    float distance = glm::max(glm::length(center - view.cameraPos) - radius, 1e-3f);
+    float pixelsPerObjectUnit = scale * view.pixelsPerUnit() / distance;
+
+    int lod = 0;
+    for (int i = static_cast<int>(data.lods.size()) - 1; i > 0; --i) {
+        float budget = i > currentLod ? LOD_PIXEL_ERROR * LOD_HYSTERESIS : LOD_PIXEL_ERROR;
+        if (data.lods[i].error * pixelsPerObjectUnit <= budget) {
+            lod = i;
+            break;
+        }
+    }
+    return lod;
+}
+
+MeshRegistry& MeshRegistry::instance() {
+    static MeshRegistry registry;
+    return registry;
+}
+
+MeshHandle MeshRegistry::acquire(const std::string& path) {
+    std::promise<MeshHandle> loaded;
+    std::shared_future<MeshHandle> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(path);
+        if (it != entries.end()) {
+            if (MeshHandle mesh = it->second.mesh.lock()) {
+                return mesh;
+            }
+            pending = it->second.loading;
+        }
+        if (!pending.valid()) {
+            entries[path].loading = loaded.get_future().share();
+        }
+    }
+
+    // Someone else is already parsing this path
+    if (pending.valid()) {
+        return pending.get();
+    }
+
+    MeshHandle mesh = std::make_shared<Mesh>(path);
+    if (loadOBJ(path, mesh->data)) {
+        mesh->computeBounds();
+        mesh->resolveMaterials();
+    } else {
+        mesh = nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (mesh) {
+            Entry& entry = entries[path];
+            entry.mesh = mesh;
+            entry.loading = {};
+        } else {
+            entries.erase(path); // let a later acquire retry
+        }
+    }
+    loaded.set_value(mesh);
+    return mesh;
+}
+
+size_t MeshRegistry::liveCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (const auto& entry : entries) {
+        if (!entry.second.mesh.expired()) ++count;
+    }
+    return count;
+}
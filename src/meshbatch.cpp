@@ -0,0 +1,255 @@
+#include "meshbatch.h"
+#include "material.h"
+#include "renderstats.h"
+#include "streambuffer.h"
+#include <iostream>
+#include <numeric>
+#include <map>
+
+namespace {
+
+bool multiDrawEnabled = true;
+
+// Built batches keyed by their meshes in part order
+std::map<std::vector<const Mesh*>, std::weak_ptr<MeshBatch>> sharedBatches;
+
+} // namespace
+
+void MeshBatch::setMultiDrawEnabled(bool enabled) {
+    multiDrawEnabled = enabled;
+}
+
+std::shared_ptr<MeshBatch> MeshBatch::acquire(const std::vector<MeshHandle>& meshes) {
+    std::vector<const Mesh*> key;
+    for (const MeshHandle& mesh : meshes) key.push_back(mesh.get());
+    std::weak_ptr<MeshBatch>& entry = sharedBatches[key];
+    if (std::shared_ptr<MeshBatch> batch = entry.lock()) {
+        return batch;
+    }
+    auto batch = std::make_shared<MeshBatch>();
+    if (!batch->build(meshes)) {
+        sharedBatches.erase(key);
+        return nullptr;
+    }
+    entry = batch;
+    return batch;
+}
+
+MeshBatch::MeshBatch()
+    : format(VertexFormat::Float), multiDraw(false),
+      VAO(0), vertexVBO(0), uvVBO(0), normalVBO(0), drawIndexVBO(0), EBO(0)
+{
+}
+
+MeshBatch::~MeshBatch() {
+    if (VAO != 0) {
+        glDeleteVertexArrays(1, &VAO);
+    }
+    GLuint buffers[] = { vertexVBO, uvVBO, normalVBO, drawIndexVBO, EBO };
+    for (GLuint buffer : buffers) {
+        if (buffer != 0) {
+            glDeleteBuffers(1, &buffer);
+        }
+    }
+}
+
+bool MeshBatch::build(const std::vector<MeshHandle>& meshes) {
+    if (VAO != 0) {
+        return true;
+    }
+
+    format = Mesh::getDefaultVertexFormat();
+    multiDraw = multiDrawEnabled &&
+                (GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance));
+
+    // Concatenate the parts; indices stay local to their mesh and baseVertex rebases them
+    std::vector<glm::vec3> positions, normals;
+    std::vector<glm::vec2> uvs;
+    std::vector<PackedVertex> packed;
+    std::vector<unsigned int> indices;
+    parts.clear();
+    for (const MeshHandle& mesh : meshes) {
+        Part part;
+        part.mesh = mesh;
+        part.baseVertex = static_cast<GLint>(format == VertexFormat::Packed ? packed.size() : positions.size());
+        part.firstIndex = static_cast<GLuint>(indices.size());
+        part.positionOffset = glm::vec3(0.0f);
+        part.positionScale = glm::vec3(1.0f);
+        if (mesh) {
+            const MeshData& data = mesh->getData();
+            if (format == VertexFormat::Packed) {
+                std::vector<PackedVertex> meshPacked = packVertices(data, mesh->getBoundsMin(), mesh->getBoundsMax());
+                packed.insert(packed.end(), meshPacked.begin(), meshPacked.end());
+                part.positionOffset = mesh->getBoundsMin();
+                part.positionScale = mesh->getBoundsMax() - mesh->getBoundsMin();
+            } else {
+                positions.insert(positions.end(), data.vertices.begin(), data.vertices.end());
+                uvs.insert(uvs.end(), data.uvs.begin(), data.uvs.end());
+                normals.insert(normals.end(), data.normals.begin(), data.normals.end());
+            }
+            indices.insert(indices.end(), data.indices.begin(), data.indices.end());
+        }
+        parts.push_back(part);
+    }
+    if (indices.empty()) {
+        std::cerr << "Error: No mesh data to build a batch from" << std::endl;
+        return false;
+    }
+
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    if (format == VertexFormat::Packed) {
+        glGenBuffers(1, &vertexVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexVBO);
+        glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(PackedVertex), packed.data(), GL_STATIC_DRAW);
+        setPackedVertexAttributes();
+    } else {
+        glGenBuffers(1, &vertexVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexVBO);
+        glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        glGenBuffers(1, &uvVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, uvVBO);
+        glBufferData(GL_ARRAY_BUFFER, uvs.size() * sizeof(glm::vec2), uvs.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (void*)0);
+        glEnableVertexAttribArray(1);
+
+        glGenBuffers(1, &normalVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, normalVBO);
+        glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3), normals.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+        glEnableVertexAttribArray(2);
+    }
+
+    // Draw index per instance; with baseInstance = record index each command reads its own.
+    // The fallback leaves the array disabled and sets the attribute's constant value instead.
+    std::vector<GLuint> drawIndices(MAX_BATCH_DRAWS);
+    std::iota(drawIndices.begin(), drawIndices.end(), 0u);
+    glGenBuffers(1, &drawIndexVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, drawIndexVBO);
+    glBufferData(GL_ARRAY_BUFFER, drawIndices.size() * sizeof(GLuint), drawIndices.data(), GL_STATIC_DRAW);
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+    glVertexAttribDivisor(3, 1);
+    if (multiDraw) {
+        glEnableVertexAttribArray(3);
+    }
+
+    // Element buffer stays bound to the VAO
+    glGenBuffers(1, &EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    drawData.reserve(MAX_BATCH_DRAWS);
+    commands.reserve(MAX_BATCH_DRAWS);
+
+    size_t vertexCount = format == VertexFormat::Packed ? packed.size() : positions.size();
+    std::cout << "Mesh batch set up: " << parts.size() << " parts, " << vertexCount << " vertices, "
+              << indices.size() / 3 << " triangles (all LODs), "
+              << (multiDraw ? "glMultiDrawElementsIndirect" : "base-vertex draw loop") << std::endl;
+    return true;
+}
+
+void MeshBatch::draw(const std::vector<BatchPart>& states, const RenderView& view) {
+    if (VAO == 0) {
+        return;
+    }
+    RenderStats& stats = frameStats();
+    glBindVertexArray(VAO);
+    ++stats.vaoBinds;
+
+    for (size_t p = 0; p < parts.size() && p < states.size(); ++p) {
+        const Part& part = parts[p];
+        if (!part.mesh) continue;
+        const BatchPart& state = states[p];
+        if (!view.frustum.intersectsBox(part.mesh->getBoundsMin(), part.mesh->getBoundsMax(), state.model)) {
+            ++stats.culledObjects;
+            continue;
+        }
+        ++stats.visibleObjects;
+        const MeshData& data = part.mesh->getData();
+        glm::mat4 normalMatrix = glm::mat4(glm::transpose(glm::inverse(glm::mat3(state.model))));
+
+        if (data.lods.empty() || data.submeshes.empty()) {
+            addDraw(part, state, normalMatrix, 0, static_cast<GLuint>(data.indices.size()), MaterialLibrary::DEFAULT_MATERIAL);
+            continue;
+        }
+        const MeshLod& range = data.lods[glm::clamp(state.lod, 0, part.mesh->lodCount() - 1)];
+        for (unsigned int s = range.firstSubmesh; s < range.firstSubmesh + range.submeshCount; ++s) {
+            const MeshSubmesh& submesh = data.submeshes[s];
+            addDraw(part, state, normalMatrix, submesh.indexOffset, submesh.indexCount, part.mesh->submeshMaterial(submesh));
+        }
+    }
+    flush();
+    glBindVertexArray(0);
+}
+
+void MeshBatch::addDraw(const Part& part, const BatchPart& state, const glm::mat4& normalMatrix,
+                        GLuint indexOffset, GLuint indexCount, unsigned int material) {
+    const Material& m = MaterialLibrary::instance().get(material);
+    BatchDrawData record;
+    record.model = state.model;
+    record.normalMatrix = normalMatrix;
+    record.baseColor = glm::vec4(state.color * m.diffuse, 1.0f);
+    record.emissive = glm::vec4(m.emissive, 0.0f);
+    record.positionOffset = glm::vec4(part.positionOffset, 0.0f);
+    record.positionScale = glm::vec4(part.positionScale, 0.0f);
+
+    DrawElementsIndirectCommand command;
+    command.count = indexCount;
+    command.instanceCount = 1;
+    command.firstIndex = part.firstIndex + indexOffset;
+    command.baseVertex = part.baseVertex;
+    command.baseInstance = static_cast<GLuint>(drawData.size());
+
+    drawData.push_back(record);
+    commands.push_back(command);
+    if (drawData.size() == MAX_BATCH_DRAWS) {
+        flush();
+    }
+}
+
+void MeshBatch::flush() {
+    if (commands.empty()) {
+        return;
+    }
+    RenderStats& stats = frameStats();
+    StreamBuffer& stream = StreamBuffer::instance();
+    // The block is declared with MAX_BATCH_DRAWS entries, so the bound range covers all of them
+    bool uploaded = stream.uploadUniforms(BATCH_DRAWS_BINDING, drawData.data(), drawData.size() * sizeof(BatchDrawData),
+                                          MAX_BATCH_DRAWS * sizeof(BatchDrawData));
+    StreamAllocation indirect;
+    if (uploaded && multiDraw) {
+        indirect = stream.upload(commands.data(), commands.size() * sizeof(DrawElementsIndirectCommand), sizeof(GLuint));
+        uploaded = indirect.valid();
+    }
+    if (!uploaded) {
+        drawData.clear();
+        commands.clear();
+        return;
+    }
+
+    if (multiDraw) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect.buffer);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)indirect.offset, static_cast<GLsizei>(commands.size()), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        ++stats.drawCalls;
+    } else {
+        for (const DrawElementsIndirectCommand& command : commands) {
+            glVertexAttribI1ui(3, command.baseInstance);
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT,
+                                     (void*)(command.firstIndex * sizeof(unsigned int)), command.baseVertex);
+            ++stats.drawCalls;
+        }
+    }
+    for (const DrawElementsIndirectCommand& command : commands) {
+        stats.triangles += command.count / 3;
+    }
+    drawData.clear();
+    commands.clear();
+}
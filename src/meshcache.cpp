@@ -0,0 +1,272 @@
+#include "meshcache.h"
+#include "utils.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MESH_CACHE_MAGIC[4] = { 'F', '1', 'M', 'B' };
+const uint32_t MESH_CACHE_VERSION = 5; // 2: stored after optimizeMesh(), 3: LOD table, 4: materials, 5: measured LOD errors
+const uint64_t PAYLOAD_ALIGNMENT = 16;
+
+struct MeshCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceHash;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t lodCount;
+    uint32_t submeshCount;
+    uint32_t materialLibCount;
+    uint32_t materialNameCount;
+    uint64_t positionsOffset;
+    uint64_t uvsOffset;
+    uint64_t normalsOffset;
+    uint64_t indicesOffset;
+    uint64_t lodsOffset;
+    uint64_t submeshesOffset;
+    uint64_t stringsOffset; // material libraries, then material names, each NUL-terminated
+    uint64_t stringsSize;
+    uint64_t fileSize;
+};
+
+struct SourceInfo {
+    uint64_t size;
+    int64_t mtime;
+};
+
+bool statSource(const std::string& path, SourceInfo& info) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    info.size = size;
+    info.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    return true;
+}
+
+uint64_t alignUp(uint64_t value) {
+    return (value + PAYLOAD_ALIGNMENT - 1) & ~(PAYLOAD_ALIGNMENT - 1);
+}
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return;
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) return;
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data != nullptr) size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) return;
+        void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) return;
+        data = static_cast<const char*>(ptr);
+        size = static_cast<size_t>(st.st_size);
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data != nullptr) UnmapViewOfFile(data);
+        if (mapping != nullptr) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (data != nullptr) munmap(const_cast<char*>(data), size);
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data = nullptr;
+    size_t size = 0;
+
+private:
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+bool headerIsSane(const MeshCacheHeader& header, size_t mappedSize) {
+    if (std::memcmp(header.magic, MESH_CACHE_MAGIC, 4) != 0) return false;
+    if (header.version != MESH_CACHE_VERSION) return false;
+    if (header.fileSize != mappedSize) return false;
+    uint64_t v = header.vertexCount;
+    return header.positionsOffset + v * sizeof(glm::vec3) <= mappedSize
+        && header.uvsOffset + v * sizeof(glm::vec2) <= mappedSize
+        && header.normalsOffset + v * sizeof(glm::vec3) <= mappedSize
+        && header.indicesOffset + uint64_t(header.indexCount) * sizeof(unsigned int) <= mappedSize
+        && header.lodsOffset + uint64_t(header.lodCount) * sizeof(MeshLod) <= mappedSize
+        && header.submeshesOffset + uint64_t(header.submeshCount) * sizeof(MeshSubmesh) <= mappedSize
+        && header.stringsOffset + header.stringsSize <= mappedSize;
+}
+
+// Splits the NUL-terminated string table; false if it holds fewer strings than expected
+bool readStrings(const char* data, uint64_t size, uint32_t libCount, uint32_t nameCount, MeshData& mesh) {
+    mesh.materialLibs.clear();
+    mesh.materialNames.clear();
+    const char* p = data;
+    const char* end = data + size;
+    for (uint32_t i = 0; i < libCount + nameCount; ++i) {
+        const char* terminator = static_cast<const char*>(std::memchr(p, '\0', end - p));
+        if (terminator == nullptr) return false;
+        (i < libCount ? mesh.materialLibs : mesh.materialNames).emplace_back(p, terminator);
+        p = terminator + 1;
+    }
+    return true;
+}
+
+template <typename T>
+void copyArray(const char* base, uint64_t offset, uint32_t count, std::vector<T>& out) {
+    const T* first = reinterpret_cast<const T*>(base + offset);
+    out.assign(first, first + count);
+}
+
+bool loadMeshCacheImpl(const std::string& objPath, const std::string* objBytes, MeshData& mesh) {
+    SourceInfo source;
+    if (!statSource(objPath, source)) return false;
+
+    std::string cachePath = meshCachePath(objPath);
+    bool refreshMtime = false;
+    {
+        MappedFile cache(cachePath);
+        if (cache.data == nullptr || cache.size < sizeof(MeshCacheHeader)) return false;
+
+        MeshCacheHeader header;
+        std::memcpy(&header, cache.data, sizeof(header));
+        if (!headerIsSane(header, cache.size)) return false;
+        if (header.sourceSize != source.size) return false;
+        if (header.sourceMtime != source.mtime) {
+            // Touched but maybe unchanged (checkout, copy): let the content decide
+            if (objBytes == nullptr || hashBytes(*objBytes) != header.sourceHash) return false;
+            refreshMtime = true;
+        }
+
+        copyArray(cache.data, header.positionsOffset, header.vertexCount, mesh.vertices);
+        copyArray(cache.data, header.uvsOffset, header.vertexCount, mesh.uvs);
+        copyArray(cache.data, header.normalsOffset, header.vertexCount, mesh.normals);
+        copyArray(cache.data, header.indicesOffset, header.indexCount, mesh.indices);
+        copyArray(cache.data, header.lodsOffset, header.lodCount, mesh.lods);
+        copyArray(cache.data, header.submeshesOffset, header.submeshCount, mesh.submeshes);
+        if (!readStrings(cache.data + header.stringsOffset, header.stringsSize,
+                         header.materialLibCount, header.materialNameCount, mesh)) {
+            return false;
+        }
+    }
+
+    if (refreshMtime) {
+        std::fstream file(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offsetof(MeshCacheHeader, sourceMtime));
+        file.write(reinterpret_cast<const char*>(&source.mtime), sizeof(source.mtime));
+    }
+    return true;
+}
+
+} // namespace
+
+std::string meshCachePath(const std::string& objPath) {
+    return std::filesystem::path(objPath).replace_extension(".f1mesh").string();
+}
+
+bool loadMeshCache(const std::string& objPath, MeshData& mesh) {
+    return loadMeshCacheImpl(objPath, nullptr, mesh);
+}
+
+bool loadMeshCache(const std::string& objPath, const std::string& objBytes, MeshData& mesh) {
+    return loadMeshCacheImpl(objPath, &objBytes, mesh);
+}
+
+bool saveMeshCache(const std::string& objPath, const std::string& objBytes, const MeshData& mesh) {
+    SourceInfo source;
+    if (!statSource(objPath, source)) return false;
+    if (mesh.uvs.size() != mesh.vertices.size() || mesh.normals.size() != mesh.vertices.size()) return false;
+
+    MeshCacheHeader header = {};
+    std::memcpy(header.magic, MESH_CACHE_MAGIC, 4);
+    header.version = MESH_CACHE_VERSION;
+    header.sourceSize = source.size;
+    header.sourceMtime = source.mtime;
+    header.sourceHash = hashBytes(objBytes);
+    header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    header.lodCount = static_cast<uint32_t>(mesh.lods.size());
+    header.submeshCount = static_cast<uint32_t>(mesh.submeshes.size());
+    header.materialLibCount = static_cast<uint32_t>(mesh.materialLibs.size());
+    header.materialNameCount = static_cast<uint32_t>(mesh.materialNames.size());
+    header.positionsOffset = alignUp(sizeof(MeshCacheHeader));
+    header.uvsOffset = alignUp(header.positionsOffset + mesh.vertices.size() * sizeof(glm::vec3));
+    header.normalsOffset = alignUp(header.uvsOffset + mesh.uvs.size() * sizeof(glm::vec2));
+    header.indicesOffset = alignUp(header.normalsOffset + mesh.normals.size() * sizeof(glm::vec3));
+    header.lodsOffset = alignUp(header.indicesOffset + mesh.indices.size() * sizeof(unsigned int));
+    std::string strings;
+    for (const std::string& library : mesh.materialLibs) strings.append(library).push_back('\0');
+    for (const std::string& name : mesh.materialNames) strings.append(name).push_back('\0');
+    header.submeshesOffset = alignUp(header.lodsOffset + mesh.lods.size() * sizeof(MeshLod));
+    header.stringsOffset = header.submeshesOffset + mesh.submeshes.size() * sizeof(MeshSubmesh);
+    header.stringsSize = strings.size();
+    header.fileSize = header.stringsOffset + strings.size();
+
+    std::string blob(header.fileSize, '\0');
+    std::memcpy(&blob[0], &header, sizeof(header));
+    std::memcpy(&blob[header.positionsOffset], mesh.vertices.data(), mesh.vertices.size() * sizeof(glm::vec3));
+    std::memcpy(&blob[header.uvsOffset], mesh.uvs.data(), mesh.uvs.size() * sizeof(glm::vec2));
+    std::memcpy(&blob[header.normalsOffset], mesh.normals.data(), mesh.normals.size() * sizeof(glm::vec3));
+    std::memcpy(&blob[header.indicesOffset], mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int));
+    if (!mesh.lods.empty()) {
+        std::memcpy(&blob[header.lodsOffset], mesh.lods.data(), mesh.lods.size() * sizeof(MeshLod));
+    }
+    if (!mesh.submeshes.empty()) {
+        std::memcpy(&blob[header.submeshesOffset], mesh.submeshes.data(), mesh.submeshes.size() * sizeof(MeshSubmesh));
+    }
+    std::memcpy(&blob[header.stringsOffset], strings.data(), strings.size());
+
+    // Write to a temporary name first so a crash never leaves a truncated cache behind
+    std::string cachePath = meshCachePath(objPath);
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(blob.data(), blob.size())) {
+            std::cerr << "Warning: Could not write mesh cache: " << cachePath << std::endl;
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        std::cerr << "Warning: Could not write mesh cache: " << cachePath << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,291 @@
+#include "meshopt.h"
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// FIFO post-transform cache model; a vertex hits while fewer than size misses happened since it was loaded
+struct FifoCache {
+    std::vector<size_t> timestamps;
+    size_t time;
+    unsigned int size;
+
+    FifoCache(size_t vertexCount, unsigned int cacheSize)
+        : timestamps(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+    // Returns 1 on a miss
+    unsigned int access(unsigned int vertex) {
+        if (time - timestamps[vertex] > size) {
+            timestamps[vertex] = time++;
+            return 1;
+        }
+        return 0;
+    }
+
+    unsigned int accessTriangle(const unsigned int* triangle) {
+        return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+    }
+
+    void flush() { time += size + 1; }
+};
+
+// Forsyth's scoring constants ("Linear-Speed Vertex Cache Optimisation", 2006)
+const float CACHE_DECAY_POWER = 1.5f;
+const float LAST_TRIANGLE_SCORE = 0.75f;
+const float VALENCE_BOOST_SCALE = 2.0f;
+const float VALENCE_BOOST_POWER = 0.5f;
+
+float vertexScore(int cachePosition, unsigned int liveTriangles, unsigned int cacheSize) {
+    if (liveTriangles == 0) {
+        return -1.0f; // nothing left to emit through this vertex
+    }
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // Vertices of the last triangle get a fixed score so it isn't simply repeated
+            score = LAST_TRIANGLE_SCORE;
+        } else {
+            float scaler = 1.0f / (cacheSize - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+        }
+    }
+    // Favour vertices with few triangles left so they don't linger as lone stragglers
+    score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(liveTriangles), -VALENCE_BOOST_POWER);
+    return score;
+}
+
+} // namespace
+
+VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize) {
+    FifoCache cache(vertexCount, cacheSize);
+    size_t misses = 0;
+    for (unsigned int index : indices) {
+        misses += cache.access(index);
+    }
+    VertexCacheStats stats;
+    stats.misses = misses;
+    stats.acmr = indices.empty() ? 0.0f : static_cast<float>(misses) / (indices.size() / 3);
+    stats.atvr = vertexCount == 0 ? 0.0f : static_cast<float>(misses) / vertexCount;
+    return stats;
+}
+
+void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) return;
+    cacheSize = std::max(cacheSize, 4u);
+
+    // Vertex -> triangle adjacency; the first liveTriangles[v] entries of each list are not yet emitted
+    std::vector<unsigned int> liveTriangles(vertexCount, 0);
+    for (unsigned int index : indices) ++liveTriangles[index];
+    std::vector<unsigned int> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + liveTriangles[v];
+    }
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<unsigned int> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        adjacency[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScores(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        vertexScores[v] = vertexScore(-1, liveTriangles[v], cacheSize);
+    }
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    long best = 0;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const unsigned int* tri = &indices[t * 3];
+        triangleScores[t] = vertexScores[tri[0]] + vertexScores[tri[1]] + vertexScores[tri[2]];
+        if (triangleScores[t] > triangleScores[best]) best = static_cast<long>(t);
+    }
+
+    std::vector<unsigned int> cache, newCache;
+    cache.reserve(cacheSize + 3);
+    newCache.reserve(cacheSize + 3);
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    size_t nextUnemitted = 0; // fallback scan when nothing in the cache has triangles left
+
+    while (best >= 0) {
+        const unsigned int* tri = &indices[best * 3];
+        result.insert(result.end(), tri, tri + 3);
+        emitted[best] = true;
+
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = tri[k];
+            unsigned int* list = &adjacency[adjacencyOffset[v]];
+            unsigned int* last = list + liveTriangles[v];
+            unsigned int* found = std::find(list, last, static_cast<unsigned int>(best));
+            if (found != last) {
+                std::swap(*found, *(last - 1));
+                --liveTriangles[v];
+            }
+        }
+
+        // The emitted triangle moves to the front of the LRU cache
+        newCache.clear();
+        for (int k = 0; k < 3; ++k) {
+            if (std::find(newCache.begin(), newCache.end(), tri[k]) == newCache.end()) {
+                newCache.push_back(tri[k]);
+            }
+        }
+        for (unsigned int v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) newCache.push_back(v);
+        }
+        for (size_t i = 0; i < newCache.size(); ++i) {
+            unsigned int v = newCache[i];
+            cachePosition[v] = i < cacheSize ? static_cast<int>(i) : -1;
+            vertexScores[v] = vertexScore(cachePosition[v], liveTriangles[v], cacheSize);
+        }
+
+        // Only triangles touching the old or new cache changed score
+        best = -1;
+        float bestScore = -1.0f;
+        for (unsigned int v : newCache) {
+            const unsigned int* list = &adjacency[adjacencyOffset[v]];
+            for (unsigned int i = 0; i < liveTriangles[v]; ++i) {
+                unsigned int t = list[i];
+                const unsigned int* other = &indices[t * 3];
+                triangleScores[t] = vertexScores[other[0]] + vertexScores[other[1]] + vertexScores[other[2]];
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+        newCache.resize(std::min<size_t>(newCache.size(), cacheSize));
+        cache.swap(newCache);
+
+        if (best < 0) {
+            while (nextUnemitted < triangleCount && emitted[nextUnemitted]) ++nextUnemitted;
+            if (nextUnemitted < triangleCount) best = static_cast<long>(nextUnemitted);
+        }
+    }
+
+    indices.swap(result);
+}
+
+void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions,
+                      float threshold, unsigned int cacheSize) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2) return;
+
+    // Hard boundaries: triangles whose three vertices all miss, i.e. where the
+    // cache-optimized order already started over
+    FifoCache cache(positions.size(), cacheSize);
+    std::vector<unsigned int> triangleMisses(triangleCount);
+    std::vector<size_t> hardBounds;
+    for (size_t t = 0; t < triangleCount; ++t) {
+        triangleMisses[t] = cache.accessTriangle(&indices[t * 3]);
+        if (t == 0 || triangleMisses[t] == 3) hardBounds.push_back(t);
+    }
+    hardBounds.push_back(triangleCount);
+
+    // Soft boundaries: split further wherever restarting from a cold cache keeps
+    // the run's ACMR within threshold of its hard cluster's
+    std::vector<size_t> clusters;
+    for (size_t h = 0; h + 1 < hardBounds.size(); ++h) {
+        size_t start = hardBounds[h], end = hardBounds[h + 1];
+        size_t clusterMisses = 0;
+        for (size_t t = start; t < end; ++t) clusterMisses += triangleMisses[t];
+        float limit = threshold * clusterMisses / (end - start);
+
+        cache.flush();
+        clusters.push_back(start);
+        size_t runStart = start, runMisses = 0;
+        for (size_t t = start; t < end; ++t) {
+            runMisses += cache.accessTriangle(&indices[t * 3]);
+            if (t + 1 < end && runMisses <= limit * (t + 1 - runStart)) {
+                clusters.push_back(t + 1);
+                cache.flush();
+                runStart = t + 1;
+                runMisses = 0;
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+    size_t clusterCount = clusters.size() - 1;
+
+    // Area-weighted centroid and normal of each cluster and of the whole mesh
+    std::vector<glm::vec3> centroids(clusterCount), normals(clusterCount);
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; ++c) {
+        glm::vec3 centroid(0.0f), normal(0.0f);
+        float area = 0.0f;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+            const glm::vec3& a = positions[indices[t * 3]];
+            const glm::vec3& b = positions[indices[t * 3 + 1]];
+            const glm::vec3& d = positions[indices[t * 3 + 2]];
+            glm::vec3 n = glm::cross(b - a, d - a);
+            float triangleArea = glm::length(n);
+            centroid += (a + b + d) * (triangleArea / 3.0f);
+            normal += n;
+            area += triangleArea;
+        }
+        meshCentroid += centroid;
+        meshArea += area;
+        centroids[c] = area > 0.0f ? centroid / area : positions[indices[clusters[c] * 3]];
+        float length = glm::length(normal);
+        normals[c] = length > 0.0f ? normal / length : glm::vec3(0.0f);
+    }
+    if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+    // Clusters facing away from the centre are likely to occlude the rest, so draw them first
+    std::vector<float> keys(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        keys[c] = glm::dot(centroids[c] - meshCentroid, normals[c]);
+    }
+    std::vector<size_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] > keys[b]; });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (size_t c : order) {
+        result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+    }
+    indices.swap(result);
+}
+
+void optimizeVertexFetch(MeshData& mesh) {
+    const unsigned int UNUSED = ~0u;
+    std::vector<unsigned int> remap(mesh.vertices.size(), UNUSED);
+    MeshData reordered;
+    reordered.vertices.reserve(mesh.vertices.size());
+    reordered.uvs.reserve(mesh.uvs.size());
+    reordered.normals.reserve(mesh.normals.size());
+
+    for (unsigned int& index : mesh.indices) {
+        if (remap[index] == UNUSED) {
+            remap[index] = static_cast<unsigned int>(reordered.vertices.size());
+            reordered.vertices.push_back(mesh.vertices[index]);
+            reordered.uvs.push_back(mesh.uvs[index]);
+            reordered.normals.push_back(mesh.normals[index]);
+        }
+        index = remap[index];
+    }
+
+    mesh.vertices.swap(reordered.vertices);
+    mesh.uvs.swap(reordered.uvs);
+    mesh.normals.swap(reordered.normals);
+}
+
+void optimizeMesh(MeshData& mesh) {
+    // Triangles never move between submeshes, so each is reordered on its own
+    std::vector<MeshSubmesh> ranges = mesh.submeshes;
+    if (ranges.empty()) {
+        ranges.push_back({ 0, 0, static_cast<unsigned int>(mesh.indices.size()) });
+    }
+    for (const MeshSubmesh& range : ranges) {
+        auto first = mesh.indices.begin() + range.indexOffset;
+        std::vector<unsigned int> indices(first, first + range.indexCount);
+        optimizeVertexCache(indices, mesh.vertices.size());
+        optimizeOverdraw(indices, mesh.vertices);
+        std::copy(indices.begin(), indices.end(), first);
+    }
+    optimizeVertexFetch(mesh);
+}
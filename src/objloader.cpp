@@ -0,0 +1,493 @@
+#include "objloader.h"
+#include "meshcache.h"
+#include "meshopt.h"
+#include "simplify.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <iomanip>
+#include <filesystem>
+
+namespace {
+
+// One face corner, 0-based; -1 means the attribute is absent or invalid
+struct ObjCorner {
+    int v, vt, vn;
+};
+
+enum RelativeFlags : unsigned char {
+    RELATIVE_V = 1,
+    RELATIVE_VT = 2,
+    RELATIVE_VN = 4,
+};
+
+struct ObjData {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> uvs;
+    std::vector<glm::vec3> normals;
+    std::vector<ObjCorner> corners; // 3 per triangle
+    // Corners that used negative (relative) indices. Those resolve against the pools
+    // of this chunk only and are rebased by the chunk's prefix counts when merging.
+    std::vector<std::pair<size_t, unsigned char>> relativeCorners;
+    std::vector<std::string> materialLibs;                    // mtllib names as written
+    std::vector<std::pair<size_t, std::string>> materialRuns; // usemtl: first corner, material name
+};
+
+// Files are split into chunks of at least this size when parsing in parallel
+const size_t MIN_CHUNK_BYTES = 1 << 20;
+// loadOBJ() only goes parallel on its own above this size
+const size_t AUTO_PARALLEL_BYTES = 16 << 20;
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    out.resize(static_cast<size_t>(size));
+    return size == 0 || file.read(&out[0], size).good();
+}
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && isSpace(*p)) ++p;
+    return p;
+}
+
+// Reads one float; leaves 0 in value when the token is missing or malformed
+inline const char* parseFloat(const char* p, const char* end, float& value) {
+    p = skipSpaces(p, end);
+    if (p < end && *p == '+') ++p;
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        value = 0.0f;
+        while (p < end && !isSpace(*p)) ++p;
+        return p;
+    }
+    return result.ptr;
+}
+
+inline const char* parseInt(const char* p, const char* end, int& value) {
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        value = 0;
+        return p;
+    }
+    return result.ptr;
+}
+
+// OBJ indices are 1-based; negative values count back from the current end of the pool
+inline int resolveIndex(int index, size_t count) {
+    if (index > 0) return index - 1;
+    if (index < 0) return static_cast<int>(count) + index;
+    return -1;
+}
+
+// Parses "v", "v/vt", "v//vn" or "v/vt/vn"
+const char* parseCorner(const char* p, const char* end, const ObjData& obj, ObjCorner& corner, unsigned char& relative) {
+    int v = 0, vt = 0, vn = 0;
+    p = parseInt(p, end, v);
+    if (p < end && *p == '/') {
+        ++p;
+        if (p < end && *p != '/') p = parseInt(p, end, vt);
+        if (p < end && *p == '/') {
+            ++p;
+            p = parseInt(p, end, vn);
+        }
+    }
+    while (p < end && !isSpace(*p)) ++p;
+
+    corner.v = resolveIndex(v, obj.positions.size());
+    corner.vt = resolveIndex(vt, obj.uvs.size());
+    corner.vn = resolveIndex(vn, obj.normals.size());
+    relative = (v < 0 ? RELATIVE_V : 0) | (vt < 0 ? RELATIVE_VT : 0) | (vn < 0 ? RELATIVE_VN : 0);
+    return p;
+}
+
+// Rest of the line without surrounding blanks
+inline std::string restOfLine(const char* p, const char* lineEnd) {
+    p = skipSpaces(p, lineEnd);
+    while (lineEnd > p && isSpace(lineEnd[-1])) --lineEnd;
+    return std::string(p, lineEnd);
+}
+
+inline void pushCorner(ObjData& obj, const ObjCorner& corner, unsigned char relative) {
+    if (relative != 0) obj.relativeCorners.emplace_back(obj.corners.size(), relative);
+    obj.corners.push_back(corner);
+}
+
+void parseOBJ(const char* p, const char* end, ObjData& obj) {
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) lineEnd = end;
+
+        p = skipSpaces(p, lineEnd);
+        const char* prefix = p;
+        while (p < lineEnd && !isSpace(*p)) ++p;
+        size_t prefixLen = p - prefix;
+
+        if (prefixLen == 1 && prefix[0] == 'v') {
+            glm::vec3 vertex;
+            p = parseFloat(p, lineEnd, vertex.z);
+            p = parseFloat(p, lineEnd, vertex.y);
+            p = parseFloat(p, lineEnd, vertex.x);
+            obj.positions.push_back(vertex);
+        }
+        else if (prefixLen == 2 && prefix[0] == 'v' && prefix[1] == 't') {
+            glm::vec2 uv;
+            p = parseFloat(p, lineEnd, uv.x);
+            p = parseFloat(p, lineEnd, uv.y);
+            obj.uvs.push_back(uv);
+        }
+        else if (prefixLen == 2 && prefix[0] == 'v' && prefix[1] == 'n') {
+            glm::vec3 normal;
+            p = parseFloat(p, lineEnd, normal.x);
+            p = parseFloat(p, lineEnd, normal.y);
+            p = parseFloat(p, lineEnd, normal.z);
+            obj.normals.push_back(normal);
+        }
+        else if (prefixLen == 1 && prefix[0] == 'f') {
+            // Polygons are triangulated as a fan around the first corner
+            ObjCorner first, prev, corner;
+            unsigned char firstRel = 0, prevRel = 0, rel = 0;
+            int count = 0;
+            p = skipSpaces(p, lineEnd);
+            while (p < lineEnd) {
+                p = parseCorner(p, lineEnd, obj, corner, rel);
+                if (count >= 2) {
+                    pushCorner(obj, first, firstRel);
+                    pushCorner(obj, prev, prevRel);
+                    pushCorner(obj, corner, rel);
+                }
+                if (count == 0) {
+                    first = corner;
+                    firstRel = rel;
+                }
+                prev = corner;
+                prevRel = rel;
+                ++count;
+                p = skipSpaces(p, lineEnd);
+            }
+        }
+        else if (prefixLen == 6 && std::memcmp(prefix, "usemtl", 6) == 0) {
+            obj.materialRuns.emplace_back(obj.corners.size(), restOfLine(p, lineEnd));
+        }
+        else if (prefixLen == 6 && std::memcmp(prefix, "mtllib", 6) == 0) {
+            std::istringstream names(restOfLine(p, lineEnd));
+            std::string name;
+            while (names >> name) obj.materialLibs.push_back(name);
+        }
+        p = lineEnd + 1;
+    }
+}
+
+// Concatenates chunk pools in file order. Absolute OBJ indices are already global;
+// relative ones are rebased by the number of elements in the preceding chunks.
+void mergeChunks(std::vector<ObjData>& chunks, ObjData& obj) {
+    size_t positions = 0, uvs = 0, normals = 0, corners = 0;
+    for (const ObjData& chunk : chunks) {
+        positions += chunk.positions.size();
+        uvs += chunk.uvs.size();
+        normals += chunk.normals.size();
+        corners += chunk.corners.size();
+    }
+    obj.positions.reserve(positions);
+    obj.uvs.reserve(uvs);
+    obj.normals.reserve(normals);
+    obj.corners.reserve(corners);
+
+    for (ObjData& chunk : chunks) {
+        int positionBase = static_cast<int>(obj.positions.size());
+        int uvBase = static_cast<int>(obj.uvs.size());
+        int normalBase = static_cast<int>(obj.normals.size());
+        size_t cornerBase = obj.corners.size();
+
+        obj.positions.insert(obj.positions.end(), chunk.positions.begin(), chunk.positions.end());
+        obj.uvs.insert(obj.uvs.end(), chunk.uvs.begin(), chunk.uvs.end());
+        obj.normals.insert(obj.normals.end(), chunk.normals.begin(), chunk.normals.end());
+        obj.corners.insert(obj.corners.end(), chunk.corners.begin(), chunk.corners.end());
+
+        // A chunk starting mid-material just continues the previous run
+        for (auto& run : chunk.materialRuns) {
+            obj.materialRuns.emplace_back(cornerBase + run.first, std::move(run.second));
+        }
+        obj.materialLibs.insert(obj.materialLibs.end(), chunk.materialLibs.begin(), chunk.materialLibs.end());
+
+        for (const auto& [slot, relative] : chunk.relativeCorners) {
+            ObjCorner& corner = obj.corners[cornerBase + slot];
+            if (relative & RELATIVE_V) corner.v += positionBase;
+            if (relative & RELATIVE_VT) corner.vt += uvBase;
+            if (relative & RELATIVE_VN) corner.vn += normalBase;
+        }
+        chunk = ObjData(); // release as we go to keep the peak footprint down
+    }
+}
+
+// Open-addressing table mapping unique (v, vt, vn) corners to output vertex indices.
+// Kept at most half full, growing if the expected count was too low, so probes stay
+// short and always reach an empty slot.
+class CornerIndexMap {
+public:
+    explicit CornerIndexMap(size_t expected) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) capacity <<= 1;
+        mask = capacity - 1;
+        slots.assign(capacity, EMPTY);
+        keys.reserve(expected);
+    }
+
+    // Returns the index for the corner and whether it was newly inserted
+    unsigned int insert(const ObjCorner& c, bool& inserted) {
+        size_t slot = hash(c) & mask;
+        while (slots[slot] != EMPTY) {
+            const ObjCorner& k = keys[slots[slot]];
+            if (k.v == c.v && k.vt == c.vt && k.vn == c.vn) {
+                inserted = false;
+                return slots[slot];
+            }
+            slot = (slot + 1) & mask;
+        }
+        unsigned int index = static_cast<unsigned int>(keys.size());
+        keys.push_back(c);
+        if (keys.size() * 2 > slots.size()) {
+            grow(); // rehashes every key, the new one included
+        } else {
+            slots[slot] = index;
+        }
+        inserted = true;
+        return index;
+    }
+
+private:
+    static constexpr unsigned int EMPTY = 0xFFFFFFFFu;
+    std::vector<unsigned int> slots;
+    std::vector<ObjCorner> keys;
+    size_t mask;
+
+    void grow() {
+        slots.assign(slots.size() * 2, EMPTY);
+        mask = slots.size() - 1;
+        for (unsigned int i = 0; i < keys.size(); ++i) {
+            size_t slot = hash(keys[i]) & mask;
+            while (slots[slot] != EMPTY) slot = (slot + 1) & mask;
+            slots[slot] = i;
+        }
+    }
+
+    static size_t hash(const ObjCorner& c) {
+        uint64_t h = static_cast<uint32_t>(c.v) * 0x9E3779B97F4A7C15ull;
+        h ^= static_cast<uint32_t>(c.vt) * 0xC2B2AE3D27D4EB4Full;
+        h ^= static_cast<uint32_t>(c.vn) * 0x165667B19E3779F9ull;
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
+// Reorders mesh.indices so each material's triangles are contiguous (materials in order
+// of first use, triangles in file order within each) and records LOD 0's submeshes
+void groupByMaterial(const ObjData& obj, MeshData& mesh) {
+    size_t triangleCount = mesh.indices.size() / 3;
+    std::vector<unsigned int> triangleMaterial(triangleCount, 0);
+    auto slotOf = [&mesh](const std::string& name) {
+        auto it = std::find(mesh.materialNames.begin(), mesh.materialNames.end(), name);
+        if (it != mesh.materialNames.end()) return static_cast<unsigned int>(it - mesh.materialNames.begin());
+        mesh.materialNames.push_back(name);
+        return static_cast<unsigned int>(mesh.materialNames.size() - 1);
+    };
+
+    size_t firstRun = obj.materialRuns.empty() ? obj.corners.size() : obj.materialRuns[0].first;
+    if (firstRun > 0 && triangleCount > 0) slotOf("");
+    for (size_t r = 0; r < obj.materialRuns.size(); ++r) {
+        size_t begin = obj.materialRuns[r].first / 3;
+        size_t end = r + 1 < obj.materialRuns.size() ? obj.materialRuns[r + 1].first / 3 : triangleCount;
+        if (begin >= end) continue; // usemtl with no faces
+        unsigned int slot = slotOf(obj.materialRuns[r].second);
+        std::fill(triangleMaterial.begin() + begin, triangleMaterial.begin() + end, slot);
+    }
+
+    // Stable counting sort of the triangles by material slot
+    std::vector<unsigned int> counts(mesh.materialNames.size() + 1, 0);
+    for (unsigned int slot : triangleMaterial) ++counts[slot + 1];
+    for (size_t i = 1; i < counts.size(); ++i) counts[i] += counts[i - 1];
+    for (size_t slot = 0; slot < mesh.materialNames.size(); ++slot) {
+        mesh.submeshes.push_back({ static_cast<unsigned int>(slot), counts[slot] * 3,
+                                   (counts[slot + 1] - counts[slot]) * 3 });
+    }
+    if (mesh.materialNames.size() > 1) {
+        std::vector<unsigned int> grouped(mesh.indices.size());
+        for (size_t t = 0; t < triangleCount; ++t) {
+            unsigned int target = counts[triangleMaterial[t]]++;
+            std::copy_n(&mesh.indices[t * 3], 3, &grouped[target * 3]);
+        }
+        mesh.indices.swap(grouped);
+    }
+    mesh.lods.push_back({ 0, static_cast<unsigned int>(mesh.indices.size()), 0.0f,
+                          0, static_cast<unsigned int>(mesh.submeshes.size()) });
+}
+
+// Turns parsed OBJ pools into an indexed mesh; returns the number of corners with no valid position
+size_t buildIndexedMesh(const ObjData& obj, MeshData& mesh) {
+    mesh.vertices.clear();
+    mesh.uvs.clear();
+    mesh.normals.clear();
+    mesh.indices.clear();
+    mesh.lods.clear();
+    mesh.submeshes.clear();
+    mesh.materialLibs = obj.materialLibs;
+    mesh.materialNames.clear();
+    mesh.indices.reserve(obj.corners.size());
+
+    size_t invalid = 0;
+    // Every corner may be unique (flat-shaded exports with one vn per face)
+    CornerIndexMap indexMap(obj.corners.size());
+    for (ObjCorner c : obj.corners) {
+        // Out-of-range references collapse onto the same "absent" key
+        if (c.v >= static_cast<int>(obj.positions.size())) c.v = -1;
+        if (c.vt >= static_cast<int>(obj.uvs.size())) c.vt = -1;
+        if (c.vn >= static_cast<int>(obj.normals.size())) c.vn = -1;
+        if (c.v < 0) ++invalid;
+
+        bool inserted;
+        unsigned int index = indexMap.insert(c, inserted);
+        mesh.indices.push_back(index);
+        if (!inserted) continue;
+
+        // Missing or invalid attributes fall back to zero
+        mesh.vertices.push_back(c.v >= 0 ? obj.positions[c.v] : glm::vec3(0.0f));
+        mesh.uvs.push_back(c.vt >= 0 ? obj.uvs[c.vt] : glm::vec2(0.0f));
+        mesh.normals.push_back(c.vn >= 0 ? obj.normals[c.vn] : glm::vec3(0.0f));
+    }
+
+    groupByMaterial(obj, mesh);
+    return invalid;
+}
+
+void reportMesh(const std::string& path, const MeshData& mesh, const VertexCacheStats& exported, double optimizeMs) {
+    // Compare against the flat, non-indexed layout this replaced (pos + uv + normal = 32 bytes)
+    const size_t vertexBytes = sizeof(glm::vec3) * 2 + sizeof(glm::vec2);
+    size_t flatBytes = mesh.indices.size() * vertexBytes;
+    size_t indexedBytes = mesh.vertices.size() * vertexBytes + mesh.indices.size() * sizeof(unsigned int);
+    VertexCacheStats optimized = analyzeVertexCache(mesh.indices, mesh.vertices.size());
+    // One write per report so parts loading on different threads don't interleave
+    std::ostringstream log;
+    log << "OBJ file loaded: " << path
+        << ". Vertices: " << mesh.vertices.size()
+        << ", Indices: " << mesh.indices.size()
+        << ", Triangles: " << mesh.indices.size() / 3 << "\n"
+        << "  VRAM: " << flatBytes / 1024 << " KB flat -> " << indexedBytes / 1024 << " KB indexed"
+        << ", vertex shader runs: " << mesh.indices.size() << " -> " << optimized.misses
+        << " (" << VERTEX_CACHE_SIZE << "-entry FIFO cache)\n"
+        << std::fixed << std::setprecision(3)
+        << "  Optimized in " << optimizeMs << " ms: ACMR " << exported.acmr << " -> " << optimized.acmr
+        << ", ATVR " << exported.atvr << " -> " << optimized.atvr << "\n";
+    std::cout << log.str() << std::flush;
+}
+
+void reportLods(const std::string& path, const MeshData& mesh, double buildMs) {
+    std::ostringstream log;
+    log << std::fixed << std::setprecision(4) << "  LODs for " << path << " built in "
+        << std::setprecision(1) << buildMs << " ms:";
+    for (const MeshLod& lod : mesh.lods) {
+        log << " " << lod.indexCount / 3 << " tris (error " << std::setprecision(4) << lod.error << ")";
+    }
+    log << "\n";
+    std::cout << log.str() << std::flush;
+}
+
+} // namespace
+
+size_t parseOBJText(const char* data, size_t size, MeshData& mesh, unsigned int threads) {
+    const char* end = data + size;
+    size_t chunkCount = std::min<size_t>(threads, size / MIN_CHUNK_BYTES);
+    if (chunkCount <= 1) {
+        ObjData obj;
+        parseOBJ(data, end, obj);
+        return buildIndexedMesh(obj, mesh);
+    }
+
+    // Split at evenly spaced offsets, each moved forward to the next line start
+    std::vector<const char*> bounds;
+    bounds.push_back(data);
+    for (size_t i = 1; i < chunkCount; ++i) {
+        const char* p = std::max(data + size * i / chunkCount, bounds.back());
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        bounds.push_back(newline != nullptr ? newline + 1 : end);
+    }
+    bounds.push_back(end);
+
+    std::vector<ObjData> chunks(chunkCount);
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < chunkCount; ++i) {
+        workers.emplace_back([&bounds, &chunks, i]() { parseOBJ(bounds[i], bounds[i + 1], chunks[i]); });
+    }
+    parseOBJ(bounds[0], bounds[1], chunks[0]);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    ObjData obj;
+    mergeChunks(chunks, obj);
+    return buildIndexedMesh(obj, mesh);
+}
+
+bool loadOBJ(const std::string& path, MeshData& mesh, unsigned int parseThreads) {
+    if (loadMeshCache(path, mesh)) {
+        std::cout << ("Mesh cache hit: " + meshCachePath(path)
+                      + ". Vertices: " + std::to_string(mesh.vertices.size())
+                      + ", Indices: " + std::to_string(mesh.indices.size())
+                      + ", LODs: " + std::to_string(mesh.lods.size()) + "\n") << std::flush;
+        return true;
+    }
+
+    std::string buffer;
+    if (!readFile(path, buffer)) {
+        std::cerr << "Error: Could not open OBJ file: " << path << std::endl;
+        return false;
+    }
+
+    // The OBJ was touched since the cache was written; reuse it if the content is the same
+    if (loadMeshCache(path, buffer, mesh)) {
+        std::cout << ("Mesh cache hit (content unchanged): " + meshCachePath(path)
+                      + ". Vertices: " + std::to_string(mesh.vertices.size())
+                      + ", Indices: " + std::to_string(mesh.indices.size())
+                      + ", LODs: " + std::to_string(mesh.lods.size()) + "\n") << std::flush;
+        return true;
+    }
+
+    if (parseThreads == 0) {
+        parseThreads = buffer.size() >= AUTO_PARALLEL_BYTES ? std::max(1u, std::thread::hardware_concurrency()) : 1;
+    }
+    size_t invalid = parseOBJText(buffer.data(), buffer.size(), mesh, parseThreads);
+    if (invalid > 0) {
+        std::cerr << "Warning: " << invalid << " invalid vertex indices in " << path << std::endl;
+    }
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    for (std::string& library : mesh.materialLibs) {
+        library = (directory / library).string();
+    }
+
+    // Exporter triangle order -> cache, overdraw and fetch friendly order
+    VertexCacheStats exported = analyzeVertexCache(mesh.indices, mesh.vertices.size());
+    auto optimizeBegin = std::chrono::steady_clock::now();
+    optimizeMesh(mesh);
+    double optimizeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - optimizeBegin).count();
+    reportMesh(path, mesh, exported, optimizeMs);
+
+    auto lodBegin = std::chrono::steady_clock::now();
+    buildMeshLods(mesh);
+    reportLods(path, mesh, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - lodBegin).count());
+
+    if (saveMeshCache(path, buffer, mesh)) {
+        std::cout << ("Mesh cache written: " + meshCachePath(path) + "\n") << std::flush;
+    }
+    return true;
+}
@@ -0,0 +1,218 @@
+#include "profiler.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+namespace {
+
+// Chrome trace strings; zone names are literals, so only quotes and backslashes need escaping
+std::string jsonString(const char* text) {
+    std::string out = "\"";
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out += '\\';
+        out += *c;
+    }
+    return out + "\"";
+}
+
+} // namespace
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler()
+    : enabled(false), epoch(std::chrono::steady_clock::now()), frame(0), frameStartUs(0),
+      nextTrack(1), timerQueries(false), droppedGpuFrames(0)
+{
+}
+
+void Profiler::setEnabled(bool enable) {
+    enabled = enable;
+    // Timer queries are core in 3.3; the check only guards odd drivers
+    timerQueries = enable && (GLEW_VERSION_3_3 || GLEW_ARB_timer_query);
+}
+
+int64_t Profiler::nowUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+int Profiler::currentTrack() {
+    // Called with the mutex held
+    thread_local int track = 0;
+    if (track == 0) track = nextTrack++;
+    return track;
+}
+
+void Profiler::beginFrame() {
+    if (!enabled) return;
+    frameStartUs = nowUs();
+
+    if (timerQueries) {
+        QueryFrame& slot = queryFrames[frame % PROFILER_QUERY_LATENCY];
+        collectGpuFrame(slot);
+        slot.used = 0;
+        slot.zones.clear();
+        slot.frame = frame;
+        // GL_TIMESTAMP reads the GPU clock without waiting for queued work
+        GLint64 gpuNowNs = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNowNs);
+        slot.gpuToCpuUs = nowUs() - gpuNowNs / 1000;
+    }
+}
+
+void Profiler::endFrame() {
+    if (!enabled) return;
+    recordCpuZone("frame", frameStartUs, nowUs());
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& zone : frameTotals) {
+        addSample(zone.first, zone.second);
+    }
+    frameTotals.clear();
+    while (!events.empty() && events.front().frame <= frame - PROFILER_TRACE_FRAMES) {
+        events.pop_front();
+    }
+    ++frame;
+}
+
+void Profiler::recordCpuZone(const char* name, int64_t startUs, int64_t endUs) {
+    if (!enabled) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back({ name, currentTrack(), startUs, endUs - startUs, frame });
+    frameTotals[name] += (endUs - startUs) / 1000.0;
+}
+
+GLuint Profiler::nextQuery(QueryFrame& slot) {
+    if (slot.used == slot.queries.size()) {
+        size_t grow = std::max<size_t>(16, slot.queries.size());
+        slot.queries.resize(slot.queries.size() + grow);
+        glGenQueries(static_cast<GLsizei>(grow), slot.queries.data() + slot.used);
+    }
+    return slot.queries[slot.used++];
+}
+
+void Profiler::beginGpuZone(const char* name) {
+    if (!timerQueries) return;
+    QueryFrame& slot = queryFrames[frame % PROFILER_QUERY_LATENCY];
+    GLuint query = nextQuery(slot);
+    glQueryCounter(query, GL_TIMESTAMP);
+    openGpuZones.push_back(slot.zones.size());
+    slot.zones.push_back({ name, query, 0 });
+}
+
+void Profiler::endGpuZone() {
+    if (!timerQueries || openGpuZones.empty()) return;
+    QueryFrame& slot = queryFrames[frame % PROFILER_QUERY_LATENCY];
+    GLuint query = nextQuery(slot);
+    glQueryCounter(query, GL_TIMESTAMP);
+    slot.zones[openGpuZones.back()].endQuery = query;
+    openGpuZones.pop_back();
+}
+
+void Profiler::collectGpuFrame(QueryFrame& slot) {
+    if (slot.frame < 0 || slot.zones.empty()) return;
+
+    // The last query issued finishes last; if it is not ready, drop the frame rather than wait
+    GLint available = 0;
+    glGetQueryObjectiv(slot.queries[slot.used - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        ++droppedGpuFrames;
+        return;
+    }
+
+    std::unordered_map<std::string, double> totals;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const GpuZone& zone : slot.zones) {
+        if (zone.endQuery == 0) continue; // left open at the end of the frame
+        GLuint64 beginNs = 0, endNs = 0;
+        glGetQueryObjectui64v(zone.beginQuery, GL_QUERY_RESULT, &beginNs);
+        glGetQueryObjectui64v(zone.endQuery, GL_QUERY_RESULT, &endNs);
+        int64_t startUs = static_cast<int64_t>(beginNs / 1000) + slot.gpuToCpuUs;
+        int64_t durationUs = static_cast<int64_t>((endNs - beginNs) / 1000);
+        events.push_back({ zone.name, GPU_TRACK, startUs, durationUs, slot.frame });
+        totals[std::string("gpu ") + zone.name] += (endNs - beginNs) / 1e6;
+    }
+    for (const auto& zone : totals) {
+        addSample(zone.first, zone.second);
+    }
+}
+
+void Profiler::addSample(const std::string& zone, double ms) {
+    // Called with the mutex held
+    ZoneStats& entry = stats[zone];
+    if (entry.samples.size() < static_cast<size_t>(PROFILER_ROLLING_FRAMES)) {
+        entry.samples.push_back(ms);
+    } else {
+        entry.samples[entry.next] = ms;
+        entry.next = (entry.next + 1) % PROFILER_ROLLING_FRAMES;
+    }
+}
+
+void Profiler::printStats(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> names;
+    for (const auto& zone : stats) names.push_back(zone.first);
+    std::sort(names.begin(), names.end());
+
+    std::ostringstream report;
+    report << "Profiler (last " << PROFILER_ROLLING_FRAMES << " frames, ms per frame: avg / p95 / p99)\n";
+    for (const std::string& name : names) {
+        std::vector<double> samples = stats.at(name).samples;
+        if (samples.empty()) continue;
+        std::sort(samples.begin(), samples.end());
+        double total = 0.0;
+        for (double ms : samples) total += ms;
+        report << "  " << name << ": " << total / samples.size() << " / "
+               << samples[samples.size() * 95 / 100] << " / " << samples[samples.size() * 99 / 100] << "\n";
+    }
+    if (droppedGpuFrames > 0) {
+        report << "  (" << droppedGpuFrames << " GPU frames dropped: results not ready after "
+               << PROFILER_QUERY_LATENCY << " frames)\n";
+    }
+    out << report.str() << std::flush;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not write trace file: " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << GPU_TRACK << ",\"args\":{\"name\":\"GPU\"}}";
+    for (int track = 1; track < nextTrack; ++track) {
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track
+             << ",\"args\":{\"name\":\"" << (track == 1 ? "main" : "thread " + std::to_string(track)) << "\"}}";
+    }
+    for (const TraceEvent& event : events) {
+        file << ",\n{\"name\":" << jsonString(event.name) << ",\"cat\":\"" << (event.track == GPU_TRACK ? "gpu" : "cpu")
+             << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.track << ",\"ts\":" << event.startUs
+             << ",\"dur\":" << event.durationUs << ",\"args\":{\"frame\":" << event.frame << "}}";
+    }
+    file << "\n]}\n";
+    std::cout << ("Chrome trace written to " + path + " (" + std::to_string(events.size()) + " events)\n") << std::flush;
+    return static_cast<bool>(file);
+}
+
+ProfileZone::ProfileZone(const char* name, Kind kind)
+    : name(name), kind(kind), startUs(0), active(Profiler::instance().isEnabled())
+{
+    if (!active) return;
+    startUs = Profiler::instance().nowUs();
+    if (kind == Gpu) {
+        Profiler::instance().beginGpuZone(name);
+    }
+}
+
+ProfileZone::~ProfileZone() {
+    if (!active) return;
+    Profiler& profiler = Profiler::instance();
+    if (kind == Gpu) {
+        profiler.endGpuZone();
+    }
+    profiler.recordCpuZone(name, startUs, profiler.nowUs());
+}
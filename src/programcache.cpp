@@ -0,0 +1,139 @@
+#include "programcache.h"
+#include "utils.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+
+namespace {
+
+const char PROGRAM_CACHE_MAGIC[4] = { 'F', '1', 'P', 'B' };
+const uint32_t PROGRAM_CACHE_VERSION = 1;
+
+struct ProgramCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t binaryFormat;
+    uint32_t binaryLength;
+};
+
+bool cacheEnabled = true;
+
+std::string glString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+std::string programCachePath(uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(PROGRAM_CACHE_DIR) / name).string();
+}
+
+} // namespace
+
+void setProgramCacheEnabled(bool enabled) {
+    cacheEnabled = enabled;
+}
+
+bool programCacheAvailable() {
+    if (!cacheEnabled || !(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)) {
+        return false;
+    }
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+uint64_t programCacheKey(const std::string& vertexSource, const std::string& fragmentSource) {
+    // The separators keep ("ab", "c") and ("a", "bc") apart
+    uint64_t key = hashBytes(vertexSource);
+    key = hashBytes(std::string(1, '\0') + fragmentSource, key);
+    key = hashBytes(std::string(1, '\0') + glString(GL_VENDOR), key);
+    key = hashBytes(std::string(1, '\0') + glString(GL_RENDERER), key);
+    key = hashBytes(std::string(1, '\0') + glString(GL_VERSION), key);
+    return key;
+}
+
+GLuint loadProgramBinary(uint64_t key) {
+    std::string path = programCachePath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    ProgramCacheHeader header;
+    std::vector<char> binary;
+    bool valid = file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+                 std::memcmp(header.magic, PROGRAM_CACHE_MAGIC, 4) == 0 &&
+                 header.version == PROGRAM_CACHE_VERSION && header.key == key && header.binaryLength > 0;
+    if (valid) {
+        binary.resize(header.binaryLength);
+        valid = static_cast<bool>(file.read(binary.data(), binary.size()));
+    }
+    file.close();
+
+    GLuint program = 0;
+    if (valid) {
+        program = glCreateProgram();
+        glProgramBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+    if (program == 0) {
+        // Stale or corrupt; the caller rebuilds from source and writes a fresh one
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+    return program;
+}
+
+bool saveProgramBinary(uint64_t key, GLuint program) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return false;
+    }
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) {
+        return false;
+    }
+
+    ProgramCacheHeader header = {};
+    std::memcpy(header.magic, PROGRAM_CACHE_MAGIC, 4);
+    header.version = PROGRAM_CACHE_VERSION;
+    header.key = key;
+    header.binaryFormat = format;
+    header.binaryLength = static_cast<uint32_t>(written);
+
+    // Write to a temporary name first so a crash never leaves a truncated binary behind
+    std::error_code ec;
+    std::filesystem::create_directories(PROGRAM_CACHE_DIR, ec);
+    std::string cachePath = programCachePath(key);
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(reinterpret_cast<const char*>(&header), sizeof(header)) ||
+            !file.write(binary.data(), written)) {
+            std::cerr << "Warning: Could not write program cache: " << cachePath << std::endl;
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        std::cerr << "Warning: Could not write program cache: " << cachePath << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -1,12 +1,40 @@
 #include "shader.h"
+#include "uniformbuffer.h"
+#include "programcache.h"
 #include <GL/glew.h>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+namespace {
+
+// Reports the compile log if the shader failed
+bool checkCompiled(GLuint shader) {
+    GLint success;
+    GLchar infoLog[512];
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        std::cerr << "ERROR::SHADER::COMPILATION_FAILED\n" << infoLog << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Lets the driver compile on as many threads as it likes (KHR_parallel_shader_compile)
+void enableParallelCompile() {
+    static bool enabled = false;
+    if (!enabled && GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    }
+    enabled = true;
+}
+
+} // namespace
 
 GLuint compileShader(const char* shaderSource, GLenum shaderType) {
 
@@ -15,12 +43,7 @@ GLuint compileShader(const char* shaderSource, GLenum shaderType) {
     glCompileShader(shader);
 
     // 检查编译错误
-    GLint success;
-    GLchar infoLog[512];
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(shader, 512, NULL, infoLog);
-        std::cerr << "ERROR::SHADER::COMPILATION_FAILED\n" << infoLog << std::endl;
+    if (!checkCompiled(shader)) {
         glDeleteShader(shader); // 删除失败的 shader
         return 0;
     }
@@ -79,3 +102,136 @@ GLuint createShaderProgram(const char* vertexShaderPath, const char* fragmentSha
 
     return programID;
 }
+
+Shader::Shader(const char* vertexShaderPath, const char* fragmentShaderPath)
+    : ID(0), vertexPath(vertexShaderPath), fragmentPath(fragmentShaderPath), vertexShader(0), fragmentShader(0),
+      pending(false), cacheable(false), fromCache(false), cacheKey(0)
+{
+    std::string vertexSource = readToString(vertexShaderPath);
+    std::string fragmentSource = readToString(fragmentShaderPath);
+    if (vertexSource.empty() || fragmentSource.empty()) {
+        std::cerr << "Failed to create shader program." << std::endl;
+        return;
+    }
+
+    cacheable = programCacheAvailable();
+    if (cacheable) {
+        cacheKey = programCacheKey(vertexSource, fragmentSource);
+        ID = loadProgramBinary(cacheKey);
+        if (ID != 0) {
+            fromCache = true;
+            reflect();
+            return;
+        }
+    }
+
+    // No status queries until finish(): each one would wait for the compiler
+    enableParallelCompile();
+    const char* vertexText = vertexSource.c_str();
+    const char* fragmentText = fragmentSource.c_str();
+    vertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertexShader, 1, &vertexText, NULL);
+    glCompileShader(vertexShader);
+    fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragmentShader, 1, &fragmentText, NULL);
+    glCompileShader(fragmentShader);
+
+    ID = glCreateProgram();
+    glAttachShader(ID, vertexShader);
+    glAttachShader(ID, fragmentShader);
+    if (cacheable) {
+        glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    glLinkProgram(ID);
+    pending = true;
+}
+
+Shader::~Shader() {
+    if (vertexShader != 0) glDeleteShader(vertexShader);
+    if (fragmentShader != 0) glDeleteShader(fragmentShader);
+    if (ID != 0) {
+        glDeleteProgram(ID);
+    }
+}
+
+bool Shader::finish() {
+    if (!pending) {
+        return ID != 0;
+    }
+    pending = false;
+
+    GLint success;
+    glGetProgramiv(ID, GL_LINK_STATUS, &success);
+    if (!success) {
+        // A failed compile is the usual cause, so its log comes first
+        bool compiled = checkCompiled(vertexShader);
+        compiled = checkCompiled(fragmentShader) && compiled;
+        if (compiled) {
+            GLchar infoLog[512];
+            glGetProgramInfoLog(ID, 512, NULL, infoLog);
+            std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        }
+        std::cerr << "Failed to create shader program from " << vertexPath << " and " << fragmentPath << std::endl;
+        glDeleteProgram(ID);
+        ID = 0;
+    }
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+    vertexShader = fragmentShader = 0;
+
+    if (ID != 0 && cacheable) {
+        saveProgramBinary(cacheKey, ID);
+    }
+    reflect();
+    return ID != 0;
+}
+
+void Shader::reflect() {
+    locations.clear();
+    draw = DrawUniforms();
+    if (ID == 0) {
+        return;
+    }
+
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<GLchar> name(maxLength > 0 ? maxLength : 1);
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, i, (GLsizei)name.size(), &length, &size, &type, name.data());
+        std::string uniformName(name.data(), length);
+        GLint location = glGetUniformLocation(ID, uniformName.c_str());
+        if (location < 0) {
+            continue; // member of a uniform block
+        }
+        locations[uniformName] = UniformHandle{location};
+        // Arrays are reported as "name[0]"; also accept the bare name
+        if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0) {
+            locations[uniformName.substr(0, uniformName.size() - 3)] = UniformHandle{location};
+        }
+    }
+
+    GLint blockCount = 0, maxBlockLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxBlockLength);
+    std::vector<GLchar> blockName(maxBlockLength > 0 ? maxBlockLength : 1);
+    for (GLint i = 0; i < blockCount; ++i) {
+        glGetActiveUniformBlockName(ID, i, (GLsizei)blockName.size(), nullptr, blockName.data());
+        GLuint binding = uniformBlockBinding(blockName.data());
+        if (binding == GL_INVALID_INDEX) {
+            std::cerr << "Warning: Uniform block " << blockName.data() << " has no binding point" << std::endl;
+            continue;
+        }
+        glUniformBlockBinding(ID, i, binding);
+    }
+
+    draw.model = uniform("model");
+    draw.objectColor = uniform("objectColor");
+    draw.positionOffset = uniform("positionOffset");
+    draw.positionScale = uniform("positionScale");
+    draw.materialDiffuse = uniform("materialDiffuse");
+    draw.materialEmissive = uniform("materialEmissive");
+}
@@ -0,0 +1,453 @@
+#include "simplify.h"
+#include "meshopt.h"
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+
+// Symmetric 4x4 error quadric, stored as its 10 unique terms plus the total plane weight
+struct Quadric {
+    double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+    double b0 = 0, b1 = 0, b2 = 0, c = 0;
+    double weight = 0;
+
+    // Adds weight * (n.p + d)^2 for the plane n.p + d = 0
+    void addPlane(double nx, double ny, double nz, double d, double w) {
+        a00 += w * nx * nx; a01 += w * nx * ny; a02 += w * nx * nz;
+        a11 += w * ny * ny; a12 += w * ny * nz; a22 += w * nz * nz;
+        b0 += w * nx * d; b1 += w * ny * d; b2 += w * nz * d;
+        c += w * d * d;
+        weight += w;
+    }
+
+    Quadric& operator+=(const Quadric& q) {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02; a11 += q.a11; a12 += q.a12; a22 += q.a22;
+        b0 += q.b0; b1 += q.b1; b2 += q.b2; c += q.c;
+        weight += q.weight;
+        return *this;
+    }
+
+    // Weighted mean squared distance of p to the accumulated planes
+    double evaluate(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a00 * x * x + a11 * y * y + a22 * z * z
+                 + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+                 + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+        return weight > 0.0 ? std::max(0.0, e / weight) : 0.0;
+    }
+};
+
+struct Collapse {
+    unsigned int from, to;
+    double error; // squared distance
+};
+
+struct PositionKey {
+    size_t operator()(const glm::vec3& p) const {
+        uint32_t bits[3];
+        std::memcpy(bits, &p, sizeof(bits));
+        uint64_t h = bits[0] * 0x9E3779B97F4A7C15ull;
+        h ^= bits[1] * 0xC2B2AE3D27D4EB4Full;
+        h ^= bits[2] * 0x165667B19E3779F9ull;
+        return static_cast<size_t>(h ^ (h >> 29));
+    }
+};
+
+// Distance from p to the triangle abc (closest point by Voronoi region, Ericson 5.1.5)
+float pointTriangleDistance(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return glm::length(ap);
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return glm::length(bp);
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return glm::length(p - (a + ab * (d1 / (d1 - d3))));
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return glm::length(cp);
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return glm::length(p - (a + ac * (d2 / (d2 - d6))));
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+        return glm::length(p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)))));
+    }
+    float denom = va + vb + vc;
+    if (denom <= 0.0f) return std::min({ glm::length(ap), glm::length(bp), glm::length(cp) }); // degenerate
+    return glm::length(p - (a + ab * (vb / denom) + ac * (vc / denom)));
+}
+
+// Uniform grid of triangles by bounding box, for nearest-surface queries
+struct TriangleGrid {
+    glm::vec3 origin;
+    float inverseCell = 1.0f;
+    int size[3] = { 1, 1, 1 };
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> triangles;
+
+    void build(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices) {
+        size_t count = indices.size() / 3;
+        glm::vec3 lo(HUGE_VALF), hi(-HUGE_VALF);
+        for (unsigned int index : indices) {
+            lo = glm::min(lo, positions[index]);
+            hi = glm::max(hi, positions[index]);
+        }
+        origin = lo;
+        // About cbrt(count) cells along the longest side
+        float extent = std::max({ hi.x - lo.x, hi.y - lo.y, hi.z - lo.z, 1e-6f });
+        float cells = std::clamp(std::cbrt(static_cast<float>(count)), 1.0f, 64.0f);
+        inverseCell = cells / extent;
+        for (int a = 0; a < 3; ++a) {
+            size[a] = std::max(1, std::min(64, static_cast<int>((hi[a] - lo[a]) * inverseCell) + 1));
+        }
+
+        // Counting sort of (cell, triangle) pairs, as in Adjacency::build
+        offsets.assign(static_cast<size_t>(size[0]) * size[1] * size[2] + 1, 0);
+        for (int pass = 0; pass < 2; ++pass) {
+            std::vector<unsigned int> fill;
+            if (pass == 1) {
+                std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+                triangles.resize(offsets.back());
+                fill.assign(offsets.begin(), offsets.end() - 1);
+            }
+            for (size_t t = 0; t < count; ++t) {
+                const glm::vec3& a = positions[indices[t * 3]];
+                const glm::vec3& b = positions[indices[t * 3 + 1]];
+                const glm::vec3& c = positions[indices[t * 3 + 2]];
+                forEachCell(glm::min(a, glm::min(b, c)), glm::max(a, glm::max(b, c)), [&](size_t cell) {
+                    if (pass == 0) ++offsets[cell + 1];
+                    else triangles[fill[cell]++] = static_cast<unsigned int>(t);
+                });
+            }
+        }
+    }
+
+    template <typename F>
+    void forEachCell(const glm::vec3& lo, const glm::vec3& hi, F&& f) const {
+        int from[3], to[3];
+        for (int a = 0; a < 3; ++a) {
+            from[a] = std::clamp(static_cast<int>(std::floor((lo[a] - origin[a]) * inverseCell)), 0, size[a] - 1);
+            to[a] = std::clamp(static_cast<int>(std::floor((hi[a] - origin[a]) * inverseCell)), 0, size[a] - 1);
+        }
+        for (int z = from[2]; z <= to[2]; ++z)
+            for (int y = from[1]; y <= to[1]; ++y)
+                for (int x = from[0]; x <= to[0]; ++x)
+                    f((static_cast<size_t>(z) * size[1] + y) * size[0] + x);
+    }
+
+    // Calls f for every triangle in a cell overlapping the box; triangles spanning
+    // several cells come up once per cell
+    template <typename F>
+    void forEach(const glm::vec3& lo, const glm::vec3& hi, F&& f) const {
+        forEachCell(lo, hi, [&](size_t cell) {
+            for (unsigned int i = offsets[cell]; i < offsets[cell + 1]; ++i) f(triangles[i]);
+        });
+    }
+};
+
+inline uint64_t edgeKey(unsigned int a, unsigned int b) {
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+// Triangle lists per vertex for the current index buffer
+struct Adjacency {
+    std::vector<unsigned int> offsets;
+    std::vector<unsigned int> triangles;
+
+    void build(const std::vector<unsigned int>& indices, size_t vertexCount) {
+        offsets.assign(vertexCount + 1, 0);
+        for (unsigned int index : indices) ++offsets[index + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        triangles.resize(indices.size());
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            triangles[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+    }
+
+    const unsigned int* begin(unsigned int v) const { return triangles.data() + offsets[v]; }
+    const unsigned int* end(unsigned int v) const { return triangles.data() + offsets[v + 1]; }
+};
+
+} // namespace
+
+std::vector<unsigned int> simplifyMesh(const std::vector<glm::vec3>& positions,
+                                       const std::vector<unsigned int>& indices,
+                                       size_t targetIndexCount, float maxError,
+                                       float* resultError) {
+    size_t vertexCount = positions.size();
+    std::vector<unsigned int> result(indices);
+
+    // Vertices sharing a position ("wedges" along uv/normal seams) collapse together
+    // and share one quadric, stored under the first vertex at that position
+    std::vector<unsigned int> canonical(vertexCount);
+    std::vector<std::vector<unsigned int>> wedges(vertexCount);
+    {
+        std::unordered_map<glm::vec3, unsigned int, PositionKey> firstAtPosition;
+        firstAtPosition.reserve(vertexCount);
+        std::vector<bool> referenced(vertexCount, false);
+        for (unsigned int index : indices) referenced[index] = true;
+        for (unsigned int v = 0; v < vertexCount; ++v) {
+            canonical[v] = firstAtPosition.emplace(positions[v], v).first->second;
+            if (referenced[v]) wedges[canonical[v]].push_back(v);
+        }
+    }
+
+    std::unordered_set<uint64_t> positionEdges, wedgeEdges;
+    positionEdges.reserve(indices.size());
+    wedgeEdges.reserve(indices.size());
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        for (int k = 0; k < 3; ++k) {
+            unsigned int a = indices[i + k], b = indices[i + (k + 1) % 3];
+            positionEdges.insert(edgeKey(canonical[a], canonical[b]));
+            wedgeEdges.insert(edgeKey(a, b));
+        }
+    }
+
+    // Area-weighted plane quadrics per position. Open borders are locked; seam edges
+    // also get a plane perpendicular to the surface so the seam keeps its shape.
+    std::vector<Quadric> quadrics(vertexCount);
+    std::vector<bool> locked(vertexCount, false);
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const glm::vec3& p0 = positions[indices[i]];
+        glm::vec3 n = glm::cross(positions[indices[i + 1]] - p0, positions[indices[i + 2]] - p0);
+        float length = glm::length(n);
+        if (length <= 0.0f) continue;
+        n /= length;
+        float area = 0.5f * length;
+        double d = -glm::dot(n, p0);
+        for (int k = 0; k < 3; ++k) {
+            quadrics[canonical[indices[i + k]]].addPlane(n.x, n.y, n.z, d, area);
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            unsigned int a = indices[i + k], b = indices[i + (k + 1) % 3];
+            unsigned int ca = canonical[a], cb = canonical[b];
+            if (positionEdges.count(edgeKey(cb, ca)) == 0) {
+                locked[ca] = locked[cb] = true;
+            } else if (wedgeEdges.count(edgeKey(b, a)) == 0) {
+                glm::vec3 edge = positions[b] - positions[a];
+                glm::vec3 side = glm::cross(edge, n);
+                float sideLength = glm::length(side);
+                if (sideLength <= 0.0f) continue;
+                side /= sideLength;
+                double sd = -glm::dot(side, positions[a]);
+                quadrics[ca].addPlane(side.x, side.y, side.z, sd, area);
+                quadrics[cb].addPlane(side.x, side.y, side.z, sd, area);
+            }
+        }
+    }
+
+    double maxSquaredError = static_cast<double>(maxError) * maxError;
+    Adjacency adjacency;
+    std::vector<unsigned int> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<Collapse> collapses;
+    std::vector<std::pair<unsigned int, unsigned int>> moves;
+    // The wedge each input vertex has collapsed into so far
+    std::vector<unsigned int> representative(vertexCount);
+    std::iota(representative.begin(), representative.end(), 0);
+
+    // Maps every wedge at position `from` onto the single wedge at `to` it shares a
+    // triangle with. Fails if any wedge has none or several (seam corners), or if a
+    // surviving triangle would flip.
+    auto planCollapse = [&](unsigned int from, unsigned int to) {
+        moves.clear();
+        for (unsigned int w : wedges[from]) {
+            if (adjacency.begin(w) == adjacency.end(w)) continue; // already collapsed away
+            unsigned int target = ~0u;
+            for (const unsigned int* t = adjacency.begin(w); t != adjacency.end(w); ++t) {
+                const unsigned int* tri = &result[*t * 3];
+                for (int k = 0; k < 3; ++k) {
+                    if (canonical[tri[k]] != to) continue;
+                    if (target != ~0u && target != tri[k]) return false;
+                    target = tri[k];
+                }
+            }
+            if (target == ~0u) return false;
+            moves.emplace_back(w, target);
+        }
+        for (const auto& move : moves) {
+            for (const unsigned int* t = adjacency.begin(move.first); t != adjacency.end(move.first); ++t) {
+                const unsigned int* tri = &result[*t * 3];
+                if (canonical[tri[0]] == to || canonical[tri[1]] == to || canonical[tri[2]] == to) continue;
+                glm::vec3 before[3], after[3];
+                for (int k = 0; k < 3; ++k) {
+                    before[k] = positions[tri[k]];
+                    after[k] = tri[k] == move.first ? positions[move.second] : before[k];
+                }
+                glm::vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+                glm::vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+                if (glm::dot(n0, n1) <= 0.0f) return false;
+            }
+        }
+        return true;
+    };
+
+    // Each pass applies the cheapest independent collapses, then rewrites the index buffer
+    while (result.size() > targetIndexCount) {
+        adjacency.build(result, vertexCount);
+
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                unsigned int a = canonical[result[i + k]], b = canonical[result[i + (k + 1) % 3]];
+                if (a == b || (locked[a] && locked[b])) continue;
+                Quadric q = quadrics[a];
+                q += quadrics[b];
+                double toB = locked[a] ? HUGE_VAL : q.evaluate(positions[b]);
+                double toA = locked[b] ? HUGE_VAL : q.evaluate(positions[a]);
+                collapses.push_back(toB <= toA ? Collapse{ a, b, toB } : Collapse{ b, a, toA });
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse& x, const Collapse& y) { return x.error < y.error; });
+
+        if (collapses.empty()) break;
+
+        // A greedy pass would otherwise take expensive collapses before cheap ones that
+        // only become available next pass, so each pass stops after looking at about as
+        // many viable candidates as collapses are still needed (each removes two triangles,
+        // most edges are listed twice)
+        size_t triangleCount = result.size() / 3;
+        size_t needed = triangleCount - targetIndexCount / 3;
+
+        std::iota(remap.begin(), remap.end(), 0);
+        std::fill(touched.begin(), touched.end(), false);
+        size_t applied = 0, viable = 0;
+        for (const Collapse& c : collapses) {
+            if (c.error > maxSquaredError || triangleCount * 3 <= targetIndexCount) break;
+            if (viable >= needed && applied > 0) break; // the rest waits for the next pass
+            if (touched[c.from] || touched[c.to]) {
+                ++viable;
+                continue;
+            }
+            if (!planCollapse(c.from, c.to)) continue;
+            ++viable;
+
+            // Freeze the one-ring so later checks in this pass see current geometry
+            for (const auto& move : moves) {
+                for (const unsigned int* t = adjacency.begin(move.first); t != adjacency.end(move.first); ++t) {
+                    const unsigned int* tri = &result[*t * 3];
+                    bool collapsing = false;
+                    for (int k = 0; k < 3; ++k) {
+                        touched[canonical[tri[k]]] = true;
+                        collapsing = collapsing || canonical[tri[k]] == c.to;
+                    }
+                    if (collapsing) --triangleCount;
+                }
+                remap[move.first] = move.second;
+            }
+            quadrics[c.to] += quadrics[c.from];
+            ++applied;
+        }
+        if (applied == 0) break;
+        for (unsigned int& r : representative) r = remap[r];
+
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            unsigned int a = remap[result[i]], b = remap[result[i + 1]], d = remap[result[i + 2]];
+            if (a == b || b == d || a == d) continue;
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = d;
+        }
+        result.resize(write);
+    }
+
+    if (resultError != nullptr) {
+        // The quadrics only give a weighted mean plane distance, which understates the
+        // real deviation, so measure how far each moved input vertex is from the result
+        std::vector<unsigned int> positionIndices(result.size());
+        for (size_t i = 0; i < result.size(); ++i) positionIndices[i] = canonical[result[i]];
+        adjacency.build(positionIndices, vertexCount);
+        TriangleGrid grid;
+        grid.build(positions, result);
+        std::vector<unsigned int> visited(result.size() / 3, 0);
+        unsigned int query = 0;
+        float maxDistance = 0.0f;
+        for (unsigned int v : indices) {
+            unsigned int at = canonical[representative[v]];
+            if (at == canonical[v] || adjacency.begin(at) == adjacency.end(at)) continue; // never moved
+            auto distanceTo = [&](unsigned int triangle) {
+                const unsigned int* tri = &result[triangle * 3];
+                return pointTriangleDistance(positions[v], positions[tri[0]], positions[tri[1]], positions[tri[2]]);
+            };
+            // The one-ring bounds the search; only vertices that could raise the max need the grid
+            float nearest = HUGE_VALF;
+            for (const unsigned int* t = adjacency.begin(at); t != adjacency.end(at); ++t) {
+                nearest = std::min(nearest, distanceTo(*t));
+            }
+            if (nearest > maxDistance) {
+                ++query;
+                grid.forEach(positions[v] - nearest, positions[v] + nearest, [&](unsigned int triangle) {
+                    if (visited[triangle] == query) return;
+                    visited[triangle] = query;
+                    nearest = std::min(nearest, distanceTo(triangle));
+                });
+            }
+            maxDistance = std::max(maxDistance, nearest);
+        }
+        *resultError = maxDistance;
+    }
+    return result;
+}
+
+void buildMeshLods(MeshData& mesh) {
+    // Levels may drift at most this far from the full mesh, relative to its bounding radius
+    const float MAX_LOD_ERROR = 0.05f;
+    const int MAX_LOD_LEVELS = 4;
+
+    if (mesh.lods.empty()) {
+        mesh.submeshes.assign(1, { 0, 0, static_cast<unsigned int>(mesh.indices.size()) });
+        mesh.lods.push_back({ 0, static_cast<unsigned int>(mesh.indices.size()), 0.0f, 0, 1 });
+    }
+    mesh.lods.resize(1);
+    const MeshLod base = mesh.lods[0];
+    mesh.submeshes.resize(base.firstSubmesh + base.submeshCount);
+    mesh.indices.resize(base.indexOffset + base.indexCount);
+    if (mesh.vertices.empty() || base.indexCount == 0) return;
+
+    glm::vec3 lo = mesh.vertices[0], hi = mesh.vertices[0];
+    for (const glm::vec3& v : mesh.vertices) {
+        lo = glm::min(lo, v);
+        hi = glm::max(hi, v);
+    }
+    float radius = 0.5f * glm::length(hi - lo);
+
+    // Every level starts from the full mesh so its error is measured against it directly.
+    // Submeshes are simplified separately; material boundaries act as locked borders.
+    size_t previousCount = base.indexCount;
+    for (int level = 1; level < MAX_LOD_LEVELS; ++level) {
+        MeshLod lod = { static_cast<unsigned int>(mesh.indices.size()), 0, 0.0f,
+                        static_cast<unsigned int>(mesh.submeshes.size()), 0 };
+        std::vector<MeshSubmesh> submeshes;
+        std::vector<unsigned int> indices;
+        for (unsigned int s = base.firstSubmesh; s < base.firstSubmesh + base.submeshCount; ++s) {
+            const MeshSubmesh source = mesh.submeshes[s];
+            auto first = mesh.indices.begin() + source.indexOffset;
+            float error = 0.0f;
+            std::vector<unsigned int> simplified = simplifyMesh(mesh.vertices, std::vector<unsigned int>(first, first + source.indexCount),
+                                                                (source.indexCount >> level) / 3 * 3, radius * MAX_LOD_ERROR, &error);
+            if (simplified.empty()) continue;
+            optimizeVertexCache(simplified, mesh.vertices.size());
+            submeshes.push_back({ source.material, static_cast<unsigned int>(lod.indexOffset + indices.size()),
+                                  static_cast<unsigned int>(simplified.size()) });
+            indices.insert(indices.end(), simplified.begin(), simplified.end());
+            lod.error = std::max(lod.error, error);
+        }
+        if (indices.empty() || indices.size() * 10 > previousCount * 9) break;
+
+        lod.indexCount = static_cast<unsigned int>(indices.size());
+        lod.submeshCount = static_cast<unsigned int>(submeshes.size());
+        mesh.indices.insert(mesh.indices.end(), indices.begin(), indices.end());
+        mesh.submeshes.insert(mesh.submeshes.end(), submeshes.begin(), submeshes.end());
+        mesh.lods.push_back(lod);
+        previousCount = indices.size();
+    }
+}
@@ -0,0 +1,61 @@
+#include "simrunner.h"
+#include <fstream>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+bool loadCarTires(VehicleParams& params) {
+    const std::string* files[TIRE_COUNT] = { &paths::FRONTLEFT, &paths::FRONTRIGHT, &paths::REARLEFT, &paths::REARRIGHT };
+    bool loaded = true;
+    for (int i = 0; i < TIRE_COUNT; ++i) {
+        loaded = loadTireParams(*files[i], params.tires[i]) && loaded;
+    }
+    return loaded;
+}
+
+SimResult runControlScript(const ControlScript& script, const VehicleState& initial, const VehicleParams& params,
+                           double rateHz, std::vector<TrajectorySample>* trajectory, int sampleEvery) {
+    SimResult result;
+    VehicleState state = initial;
+    ControlPlayer player(script);
+    const double step = 1.0 / rateHz;
+    const long steps = static_cast<long>(std::ceil(script.duration * rateHz - 1e-9));
+    sampleEvery = std::max(sampleEvery, 1);
+
+    for (long i = 0; i < steps; ++i) {
+        // Times from the step count, so long runs don't accumulate rounding
+        double time = i * step;
+        const VehicleControls& controls = player.advance(time);
+        if (trajectory && i % sampleEvery == 0) {
+            trajectory->push_back({ time, state, controls });
+        }
+        glm::vec3 before = state.position;
+        stepVehicle(state, controls, params, static_cast<float>(step));
+        result.distance += glm::length(state.position - before);
+        result.topSpeed = std::max(result.topSpeed, state.speed());
+    }
+    result.final = state;
+    result.steps = steps;
+    result.time = steps * step;
+    if (trajectory) {
+        trajectory->push_back({ result.time, state, player.advance(result.time) });
+    }
+    return result;
+}
+
+bool writeTrajectoryCSV(const std::string& path, const std::vector<TrajectorySample>& samples) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not write trajectory: " << path << std::endl;
+        return false;
+    }
+    file << "time,x,y,z,heading,speed,yaw_rate,steering,throttle,brake,left,right\n";
+    for (const TrajectorySample& sample : samples) {
+        const VehicleState& s = sample.state;
+        file << sample.time << ',' << s.position.x << ',' << s.position.y << ',' << s.position.z << ','
+             << s.heading << ',' << s.speed() << ',' << s.yawRate << ',' << s.steering << ','
+             << sample.controls.throttle << ',' << sample.controls.brake << ','
+             << sample.controls.left << ',' << sample.controls.right << '\n';
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,128 @@
+#include "simthread.h"
+#include "audio.h"
+#include "profiler.h"
+#include <algorithm>
+
+namespace {
+
+const uint8_t CONTROL_THROTTLE = 1, CONTROL_BRAKE = 2, CONTROL_LEFT = 4, CONTROL_RIGHT = 8;
+
+} // namespace
+
+SimThread::SimThread(const VehicleState& initial, const VehicleParams& params, CarAudio* audio, double rateHz)
+    : state(initial), previous(initial), params(params), audio(audio), controlBits(0), running(false),
+      epoch(std::chrono::steady_clock::now()), step(1.0 / rateHz), accumulator(0.0), simTime(0.0),
+      stepCount(0), dropped(0.0)
+{
+    VehicleSnapshot& snapshot = snapshots.writeBuffer();
+    snapshot.previous = initial;
+    snapshot.current = initial;
+    snapshots.publish();
+}
+
+SimThread::~SimThread() {
+    stop();
+}
+
+double SimThread::now() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void SimThread::start() {
+    if (isRunning()) {
+        return;
+    }
+    accumulator = 0.0;
+    simTime = now();
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&SimThread::run, this);
+}
+
+void SimThread::stop() {
+    running.store(false, std::memory_order_release);
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void SimThread::setControls(const VehicleControls& controls) {
+    uint8_t bits = (controls.throttle ? CONTROL_THROTTLE : 0) | (controls.brake ? CONTROL_BRAKE : 0) |
+                   (controls.left ? CONTROL_LEFT : 0) | (controls.right ? CONTROL_RIGHT : 0);
+    controlBits.store(bits, std::memory_order_relaxed);
+}
+
+VehicleControls SimThread::controls() const {
+    uint8_t bits = controlBits.load(std::memory_order_relaxed);
+    VehicleControls controls;
+    controls.throttle = bits & CONTROL_THROTTLE;
+    controls.brake = bits & CONTROL_BRAKE;
+    controls.left = bits & CONTROL_LEFT;
+    controls.right = bits & CONTROL_RIGHT;
+    return controls;
+}
+
+void SimThread::run() {
+    using clock = std::chrono::steady_clock;
+    // Wakes once per step; oversleeping is made up by the accumulator
+    const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(step));
+    const auto catchUp = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(SIM_MAX_CATCH_UP_SECONDS));
+    auto next = clock::now();
+    auto last = next;
+    while (running.load(std::memory_order_acquire)) {
+        next += period;
+        std::this_thread::sleep_until(next);
+        auto current = clock::now();
+        update(std::chrono::duration<double>(current - last).count());
+        last = current;
+        if (current > next + catchUp) {
+            next = current; // don't race to catch up after a long stall
+        }
+    }
+}
+
+void SimThread::advance(double dt) {
+    update(dt);
+}
+
+void SimThread::update(double elapsed) {
+    ProfileZone zone("vehicle step");
+    accumulator += elapsed;
+    double limit = std::max(SIM_MAX_CATCH_UP_SECONDS, step);
+    if (accumulator > limit) {
+        dropped += accumulator - limit;
+        simTime += accumulator - limit;
+        accumulator = limit;
+    }
+
+    VehicleSnapshot& snapshot = snapshots.writeBuffer();
+    VehicleControls controls = this->controls();
+    bool stepped = false;
+    while (accumulator >= step) {
+        previous = state;
+        stepVehicle(state, controls, params, static_cast<float>(step));
+        accumulator -= step;
+        simTime += step;
+        ++stepCount;
+        stepped = true;
+    }
+    snapshot.previous = previous;
+    snapshot.current = state;
+    snapshot.controls = controls;
+    snapshot.time = simTime;
+    snapshot.alpha = static_cast<float>(accumulator / step);
+    snapshots.publish();
+
+    if (audio && stepped) {
+        ProfileZone audioZone("audio update");
+        audio->update(controls.throttle ? 1.0f : 0.0f, controls.brake ? 1.0f : 0.0f,
+                      static_cast<float>(state.rpm()));
+    }
+}
+
+VehicleState SimThread::sample() {
+    snapshots.fetch();
+    const VehicleSnapshot& snapshot = snapshots.read();
+    // Drawn one step behind the simulation: previous -> current until the next snapshot lands
+    float t = isRunning() ? static_cast<float>((now() - snapshot.time) / step) : snapshot.alpha;
+    return interpolate(snapshot.previous, snapshot.current, std::clamp(t, 0.0f, 1.0f));
+}
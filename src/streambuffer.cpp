@@ -0,0 +1,161 @@
+#include "streambuffer.h"
+#include <cstring>
+#include <string>
+#include <iostream>
+#include <algorithm>
+
+StreamBuffer& StreamBuffer::instance() {
+    static StreamBuffer stream;
+    return stream;
+}
+
+StreamBuffer::StreamBuffer()
+    : buffer(0), mapped(nullptr), frameSize(0), used(0), peakUsed(0), region(0),
+      fences(), uniformAlignment(256), overflowReported(false), waits(0)
+{
+}
+
+bool StreamBuffer::initialize(size_t size) {
+    if (buffer != 0) {
+        return true;
+    }
+    frameSize = size;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+    uniformAlignment = std::max(uniformAlignment, 1);
+
+    // GL_COPY_WRITE_BUFFER leaves the array, uniform and indirect bindings untouched
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    if (GLEW_ARB_buffer_storage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLsizeiptr total = static_cast<GLsizeiptr>(frameSize * STREAM_BUFFER_FRAMES);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, total, nullptr, flags);
+        mapped = static_cast<char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, total, flags));
+        if (!mapped) {
+            // Immutable storage can't fall back to orphaning; start over with a mutable buffer
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            glDeleteBuffers(1, &buffer);
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        }
+    }
+    if (!mapped) {
+        glBufferData(GL_COPY_WRITE_BUFFER, frameSize, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    // The first beginFrame moves to region 0
+    region = STREAM_BUFFER_FRAMES - 1;
+    std::cout << "Stream buffer set up: " << frameSize / 1024 << " KB per frame, "
+              << (mapped ? "persistent mapping, " + std::to_string(STREAM_BUFFER_FRAMES) + " fenced regions"
+                         : std::string("orphaned every frame"))
+              << std::endl;
+    return true;
+}
+
+void StreamBuffer::shutdown() {
+    for (GLsync& fence : fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (buffer != 0) {
+        if (mapped) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            mapped = nullptr;
+        }
+        glDeleteBuffers(1, &buffer);
+        buffer = 0;
+    }
+}
+
+void StreamBuffer::beginFrame() {
+    if (buffer == 0) {
+        return;
+    }
+    used = 0;
+    if (!mapped) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        // Orphan: last frame's draws keep the old storage, this frame gets fresh memory
+        glBufferData(GL_COPY_WRITE_BUFFER, frameSize, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        return;
+    }
+
+    region = (region + 1) % STREAM_BUFFER_FRAMES;
+    GLsync& fence = fences[region];
+    if (!fence) {
+        return;
+    }
+    // Poll first so waits are only counted when the GPU really is behind
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        ++waits;
+        do {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        } while (status == GL_TIMEOUT_EXPIRED);
+    }
+    if (status == GL_WAIT_FAILED) {
+        std::cerr << "Error: Waiting on the stream buffer fence failed" << std::endl;
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::endFrame() {
+    peakUsed = std::max(peakUsed, used);
+    if (mapped) {
+        fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
+
+StreamAllocation StreamBuffer::allocate(size_t size, size_t alignment) {
+    size_t offset = (used + alignment - 1) / alignment * alignment;
+    if (buffer == 0 || offset + size > frameSize) {
+        if (buffer != 0 && !overflowReported) {
+            std::cerr << "Error: Stream buffer frame of " << frameSize << " bytes is full; dropping dynamic uploads" << std::endl;
+            overflowReported = true;
+        }
+        return StreamAllocation();
+    }
+    used = offset + size;
+
+    StreamAllocation allocation;
+    allocation.buffer = buffer;
+    allocation.offset = static_cast<GLintptr>((mapped ? region * frameSize : 0) + offset);
+    allocation.size = size;
+    return allocation;
+}
+
+void StreamBuffer::write(const StreamAllocation& allocation, const void* data, size_t size) {
+    if (mapped) {
+        std::memcpy(mapped + allocation.offset, data, size);
+    } else {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, allocation.offset, size, data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+}
+
+StreamAllocation StreamBuffer::upload(const void* data, size_t size, size_t alignment) {
+    StreamAllocation allocation = allocate(size, alignment);
+    if (!allocation.valid()) {
+        return allocation;
+    }
+    write(allocation, data, size);
+    return allocation;
+}
+
+bool StreamBuffer::uploadUniforms(GLuint binding, const void* data, size_t size, size_t reserve) {
+    size_t range = std::max(size, reserve);
+    StreamAllocation allocation = allocate(range, static_cast<size_t>(uniformAlignment));
+    if (!allocation.valid()) {
+        return false;
+    }
+    write(allocation, data, size);
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, allocation.offset, static_cast<GLsizeiptr>(range));
+    return true;
+}
@@ -0,0 +1,366 @@
+#include "sweep.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <cmath>
+#include <limits>
+#include "utils.h"
+
+namespace {
+
+struct SweepParameter {
+    const char* name;
+    void (*set)(VehicleParams&, float);
+};
+
+void scaleGrip(VehicleParams& params, int first, float scale) {
+    for (int i = first; i < first + 2; ++i) {
+        params.tires[i].longitudinal.D *= scale;
+        params.tires[i].lateral.D *= scale;
+    }
+}
+
+const SweepParameter PARAMETERS[] = {
+    { "wheelbase",         [](VehicleParams& p, float v) { p.wheelbase = v; } },
+    { "maxSteeringAngle",  [](VehicleParams& p, float v) { p.maxSteeringAngle = v; } },
+    { "steeringRate",      [](VehicleParams& p, float v) { p.steeringRate = v; } },
+    { "throttleForce",     [](VehicleParams& p, float v) { p.throttleForce = v; } },
+    { "brakeForce",        [](VehicleParams& p, float v) { p.brakeForce = v; } },
+    { "dragCoefficient",   [](VehicleParams& p, float v) { p.dragCoefficient = v; } },
+    { "mass",              [](VehicleParams& p, float v) { p.mass = v; } },
+    { "yawInertia",        [](VehicleParams& p, float v) { p.yawInertia = v; } },
+    { "frontWeight",       [](VehicleParams& p, float v) { p.frontWeight = v; } },
+    { "cgHeight",          [](VehicleParams& p, float v) { p.cgHeight = v; } },
+    { "trackWidth",        [](VehicleParams& p, float v) { p.trackWidth = v; } },
+    { "dragArea",          [](VehicleParams& p, float v) { p.dragArea = v; } },
+    { "downforceArea",     [](VehicleParams& p, float v) { p.downforceArea = v; } },
+    { "aeroBalance",       [](VehicleParams& p, float v) { p.aeroBalance = v; } },
+    { "maxDriveForce",     [](VehicleParams& p, float v) { p.maxDriveForce = v; } },
+    { "enginePower",       [](VehicleParams& p, float v) { p.enginePower = v; } },
+    { "maxBrakeForce",     [](VehicleParams& p, float v) { p.maxBrakeForce = v; } },
+    { "brakeBias",         [](VehicleParams& p, float v) { p.brakeBias = v; } },
+    { "rollingResistance", [](VehicleParams& p, float v) { p.rollingResistance = v; } },
+    // Multiply the peak friction (D) of both curves of one axle's tires
+    { "frontGrip",         [](VehicleParams& p, float v) { scaleGrip(p, TIRE_FRONT_LEFT, v); } },
+    { "rearGrip",          [](VehicleParams& p, float v) { scaleGrip(p, TIRE_REAR_LEFT, v); } },
+};
+
+// splitmix64: small, and identical on every standard library, unlike the
+// std:: distributions
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [0, 1)
+double uniform(uint64_t& state) {
+    return (splitmix64(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Shifts each manoeuvre (events with no gap over SWEEP_JITTER_CLUSTER_GAP or
+// 2 * jitter) by one random offset, so its inputs keep their relative timing:
+// a lane change stays symmetric and leaves no steering lock behind. Manoeuvres
+// further apart than 2 * jitter cannot pass each other, so the script stays sorted.
+ControlScript jitterScript(const ControlScript& script, double jitter, uint64_t& rng) {
+    ControlScript jittered = script;
+    const double gap = std::max(SWEEP_JITTER_CLUSTER_GAP, 2.0 * jitter);
+    double offset = 0.0;
+    for (size_t i = 0; i < jittered.events.size(); ++i) {
+        double time = script.events[i].time;
+        if (i == 0 || time - script.events[i - 1].time > gap) {
+            offset = std::max((uniform(rng) * 2.0 - 1.0) * jitter, -time);
+        }
+        jittered.events[i].time = time + offset;
+    }
+    return jittered;
+}
+
+// A worker's slice of the index range
+struct alignas(64) WorkRange {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+} // namespace
+
+const std::vector<std::string>& sweepParameterNames() {
+    static const std::vector<std::string> names = []() {
+        std::vector<std::string> list;
+        for (const SweepParameter& parameter : PARAMETERS) list.push_back(parameter.name);
+        return list;
+    }();
+    return names;
+}
+
+bool setSweepParameter(VehicleParams& params, const std::string& name, float value) {
+    for (const SweepParameter& parameter : PARAMETERS) {
+        if (name == parameter.name) {
+            parameter.set(params, value);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseSweepAxis(const std::string& spec, SweepAxis& axis) {
+    size_t equals = spec.find('=');
+    if (equals == std::string::npos) {
+        std::cerr << "Error: expected name=min:max:count or name=a,b,c, got " << spec << std::endl;
+        return false;
+    }
+    axis.name = spec.substr(0, equals);
+    axis.values.clear();
+    const auto& names = sweepParameterNames();
+    if (std::find(names.begin(), names.end(), axis.name) == names.end()) {
+        std::cerr << "Error: unknown sweep parameter " << axis.name << std::endl;
+        return false;
+    }
+
+    std::string values = spec.substr(equals + 1);
+    float low, high;
+    int count;
+    char colon1, colon2, extra;
+    std::istringstream range(values);
+    if (range >> low >> colon1 >> high >> colon2 >> count && colon1 == ':' && colon2 == ':' && !(range >> extra)) {
+        if (count < 1) {
+            std::cerr << "Error: " << axis.name << " needs at least one value" << std::endl;
+            return false;
+        }
+        for (int i = 0; i < count; ++i) {
+            axis.values.push_back(count == 1 ? low : low + (high - low) * i / (count - 1));
+        }
+        return true;
+    }
+
+    std::istringstream list(values);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        char* end = nullptr;
+        float value = std::strtof(item.c_str(), &end);
+        if (item.empty() || *end != '\0') {
+            std::cerr << "Error: bad value '" << item << "' for " << axis.name << std::endl;
+            return false;
+        }
+        axis.values.push_back(value);
+    }
+    if (axis.values.empty()) {
+        std::cerr << "Error: " << axis.name << " needs at least one value" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+uint64_t sweepSeed(uint64_t seed, size_t job) {
+    uint64_t state = seed ^ (static_cast<uint64_t>(job) * 0xD1B54A32D192ED03ull);
+    return splitmix64(state);
+}
+
+float runSweepJob(const SweepConfig& config, const VehicleParams& params, uint64_t seed, bool& finished) {
+    uint64_t rng = seed;
+    const double step = 1.0 / config.rateHz;
+    const long maxSteps = static_cast<long>(std::ceil(config.maxTime * config.rateHz));
+
+    VehicleState state;
+    state.velocity = glm::vec3(config.startSpeed, 0.0f, 0.0f);
+    for (int i = 0; i < TIRE_COUNT; ++i) {
+        state.wheelSpeed[i] = config.startSpeed / params.tires[i].radius;
+    }
+    finished = false;
+
+    if (config.metric == SweepMetric::StoppingDistance) {
+        double reaction = uniform(rng) * config.jitter;
+        VehicleControls controls;
+        float distance = 0.0f;
+        for (long i = 0; i < maxSteps; ++i) {
+            controls.brake = i * step >= reaction;
+            float before = state.speed();
+            glm::vec3 from = state.position;
+            stepVehicle(state, controls, params, static_cast<float>(step));
+            float travelled = glm::length(state.position - from);
+            float after = state.speed();
+            if (controls.brake && after < SWEEP_STOP_SPEED) {
+                // Only the part of the step above the stop speed
+                float t = before > after ? (before - SWEEP_STOP_SPEED) / (before - after) : 1.0f;
+                finished = true;
+                return distance + travelled * std::clamp(t, 0.0f, 1.0f);
+            }
+            distance += travelled;
+        }
+        return distance;
+    }
+
+    ControlScript script = config.jitter > 0.0 ? jitterScript(config.script, config.jitter, rng) : config.script;
+    ControlPlayer player(script);
+    VehicleControls fullThrottle;
+    fullThrottle.throttle = true;
+    const bool scripted = !script.events.empty();
+    float distance = 0.0f;
+    for (long i = 0; i < maxSteps; ++i) {
+        double time = i * step;
+        const VehicleControls& controls = scripted ? player.advance(time) : fullThrottle;
+        glm::vec3 from = state.position;
+        stepVehicle(state, controls, params, static_cast<float>(step));
+        float travelled = glm::length(state.position - from);
+        if (distance + travelled >= config.lapDistance) {
+            // Crossing time within the step, so the grid isn't quantized to steps
+            finished = true;
+            return static_cast<float>(time + step * (config.lapDistance - distance) / travelled);
+        }
+        distance += travelled;
+    }
+    return static_cast<float>(maxSteps * step);
+}
+
+unsigned parallelFor(size_t count, unsigned threads, const std::function<void(size_t)>& job) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, count)));
+    if (threads == 1) {
+        for (size_t i = 0; i < count; ++i) job(i);
+        return threads;
+    }
+
+    // Contiguous slices keep each worker on neighbouring grid points; the
+    // locks are only contended while stealing
+    std::unique_ptr<WorkRange[]> ranges(new WorkRange[threads]);
+    for (unsigned w = 0; w < threads; ++w) {
+        ranges[w].begin = count * w / threads;
+        ranges[w].end = count * (w + 1) / threads;
+    }
+
+    auto work = [&](unsigned self) {
+        WorkRange& own = ranges[self];
+        for (;;) {
+            size_t index;
+            {
+                std::lock_guard<std::mutex> lock(own.mutex);
+                index = own.begin < own.end ? own.begin++ : count;
+            }
+            if (index < count) {
+                job(index);
+                continue;
+            }
+
+            // Steal the back half of the largest slice. Nothing is added after
+            // the start, so once every slice is empty the range is done.
+            unsigned victim = threads;
+            size_t largest = 0;
+            for (unsigned w = 0; w < threads; ++w) {
+                if (w == self) continue;
+                std::lock_guard<std::mutex> lock(ranges[w].mutex);
+                size_t remaining = ranges[w].end - ranges[w].begin;
+                if (remaining > largest) {
+                    largest = remaining;
+                    victim = w;
+                }
+            }
+            if (victim == threads) return;
+
+            size_t begin, end;
+            {
+                std::lock_guard<std::mutex> lock(ranges[victim].mutex);
+                size_t remaining = ranges[victim].end - ranges[victim].begin;
+                if (remaining == 0) continue; // taken meanwhile, look again
+                end = ranges[victim].end;
+                begin = end - (remaining + 1) / 2;
+                ranges[victim].end = begin;
+            }
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = begin;
+            own.end = end;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned w = 1; w < threads; ++w) {
+        workers.emplace_back(work, w);
+    }
+    work(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    return threads;
+}
+
+SweepResult runSweep(const SweepConfig& config) {
+    SweepResult result;
+    size_t points = 1;
+    for (const SweepAxis& axis : config.axes) {
+        points *= axis.values.size();
+    }
+    const int samples = std::max(config.samples, 1);
+    result.jobs = points * samples;
+
+    // Each job writes only its own slot, so there's nothing to lock
+    std::vector<float> values(result.jobs);
+    std::vector<char> finished(result.jobs);
+    auto start = std::chrono::steady_clock::now();
+    result.threads = parallelFor(result.jobs, config.threads, [&](size_t job) {
+        size_t point = job / samples;
+        VehicleParams params = config.base;
+        for (size_t a = config.axes.size(); a-- > 0;) {
+            const SweepAxis& axis = config.axes[a];
+            setSweepParameter(params, axis.name, axis.values[point % axis.values.size()]);
+            point /= axis.values.size();
+        }
+        bool done;
+        values[job] = runSweepJob(config, params, sweepSeed(config.seed, job), done);
+        finished[job] = done;
+    });
+    result.wallMs = millisecondsSince(start);
+
+    result.rows.resize(points);
+    for (size_t p = 0; p < points; ++p) {
+        SweepRow& row = result.rows[p];
+        size_t index = p;
+        row.values.resize(config.axes.size());
+        for (size_t a = config.axes.size(); a-- > 0;) {
+            const SweepAxis& axis = config.axes[a];
+            row.values[a] = axis.values[index % axis.values.size()];
+            index /= axis.values.size();
+        }
+        double sum = 0.0;
+        row.min = std::numeric_limits<float>::infinity();
+        row.max = -std::numeric_limits<float>::infinity();
+        for (int s = 0; s < samples; ++s) {
+            size_t job = p * samples + s;
+            if (!finished[job]) continue;
+            ++row.finished;
+            sum += values[job];
+            row.min = std::min(row.min, values[job]);
+            row.max = std::max(row.max, values[job]);
+        }
+        if (row.finished > 0) {
+            row.mean = static_cast<float>(sum / row.finished);
+        } else {
+            row.mean = row.min = row.max = std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+    return result;
+}
+
+bool writeSweepCSV(const std::string& path, const SweepConfig& config, const SweepResult& result) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not write sweep results: " << path << std::endl;
+        return false;
+    }
+    for (const SweepAxis& axis : config.axes) {
+        file << axis.name << ',';
+    }
+    file << "mean,min,max,finished\n";
+    for (const SweepRow& row : result.rows) {
+        for (float value : row.values) {
+            file << value << ',';
+        }
+        file << row.mean << ',' << row.min << ',' << row.max << ',' << row.finished << '\n';
+    }
+    return static_cast<bool>(file);
+}
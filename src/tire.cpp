@@ -0,0 +1,112 @@
+#include "tire.h"
+#include <INIReader.h>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+const float HALF_PI = 1.57079632679f;
+const float PI = 3.14159265359f;
+
+// The helpers below avoid branches (and arithmetic inside conditionals, which
+// the compiler won't speculate), so evaluateTires' loop vectorizes.
+
+// atan to about 2e-6 rad: odd polynomial on [0, 1], atan(x) = pi/2 - atan(1/x) above
+inline float fastAtan(float x) {
+    float a = std::fabs(x);
+    float z = std::min(a, 1.0f / a);
+    float z2 = z * z;
+    float p = z * (0.99997726f + z2 * (-0.33262347f + z2 * (0.19354346f + z2 * (-0.11643287f +
+                    z2 * (0.05265332f + z2 * -0.01172120f)))));
+    float inverted = static_cast<float>(a > 1.0f);
+    return std::copysign(p + inverted * (HALF_PI - 2.0f * p), x);
+}
+
+// sin on [-pi, pi] to about 4e-6: fold onto [-pi/2, pi/2], then Taylor to x^9
+inline float fastSin(float x) {
+    float a = std::fabs(x);
+    x = std::copysign(std::min(a, PI - a), x);
+    float x2 = x * x;
+    return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f + x2 * (1.0f / 362880.0f)))));
+}
+
+inline float fastCos(float x) {
+    return fastSin(HALF_PI - std::fabs(x));
+}
+
+// D scaled by the load is applied by the caller
+inline float magicFormula(float x, float B, float C, float E) {
+    float bx = B * x;
+    return fastSin(C * fastAtan(bx - E * (bx - fastAtan(bx))));
+}
+
+// d/dx of magicFormula
+inline float magicFormulaSlope(float x, float B, float C, float E) {
+    float bx = B * x;
+    float phi = bx - E * (bx - fastAtan(bx));
+    float dphi = B * (1.0f - E + E / (1.0f + bx * bx));
+    return fastCos(C * fastAtan(phi)) * C / (1.0f + phi * phi) * dphi;
+}
+
+void readCurve(const INIReader& ini, const char* section, MagicFormula& curve) {
+    curve.B = static_cast<float>(ini.GetReal(section, "B", curve.B));
+    curve.C = static_cast<float>(ini.GetReal(section, "C", curve.C));
+    curve.D = static_cast<float>(ini.GetReal(section, "D", curve.D));
+    curve.E = static_cast<float>(ini.GetReal(section, "E", curve.E));
+}
+
+} // namespace
+
+bool loadTireParams(const std::string& path, TireParams& tire) {
+    INIReader ini(path);
+    if (ini.ParseError() != 0) {
+        std::cerr << "Warning: could not read tire parameters from " << path << ", using defaults" << std::endl;
+        return false;
+    }
+    TireParams loaded = tire;
+    readCurve(ini, "longitudinal", loaded.longitudinal);
+    readCurve(ini, "lateral", loaded.lateral);
+    loaded.radius = static_cast<float>(ini.GetReal("tire", "radius", loaded.radius));
+    loaded.inertia = static_cast<float>(ini.GetReal("tire", "inertia", loaded.inertia));
+    if (loaded.radius <= 0.0f || loaded.inertia <= 0.0f) {
+        std::cerr << "Warning: " << path << " needs a positive radius and inertia, using defaults" << std::endl;
+        return false;
+    }
+    tire = loaded;
+    return true;
+}
+
+void TireSet::set(int wheel, const TireParams& tire) {
+    Bx[wheel] = tire.longitudinal.B;
+    Cx[wheel] = tire.longitudinal.C;
+    Dx[wheel] = tire.longitudinal.D;
+    Ex[wheel] = tire.longitudinal.E;
+    By[wheel] = tire.lateral.B;
+    Cy[wheel] = tire.lateral.C;
+    Dy[wheel] = tire.lateral.D;
+    Ey[wheel] = tire.lateral.E;
+}
+
+void evaluateTires(const TireSet& tires, TireBatch& batch) {
+    float usage[TIRE_COUNT];
+    for (int i = 0; i < TIRE_COUNT; ++i) {
+        float load = std::max(batch.load[i], 0.0f);
+        float fxMax = tires.Dx[i] * load + 1e-3f;
+        float fyMax = tires.Dy[i] * load + 1e-3f;
+        float fx = fxMax * magicFormula(batch.slipRatio[i], tires.Bx[i], tires.Cx[i], tires.Ex[i]);
+        float fy = fyMax * magicFormula(batch.slipAngle[i], tires.By[i], tires.Cy[i], tires.Ey[i]);
+        float slope = fxMax * magicFormulaSlope(batch.slipRatio[i], tires.Bx[i], tires.Cx[i], tires.Ex[i]);
+        batch.fx[i] = fx;
+        batch.fy[i] = fy;
+        batch.stiffness[i] = std::max(slope, 0.0f);
+        usage[i] = std::max((fx / fxMax) * (fx / fxMax) + (fy / fyMax) * (fy / fyMax), 1.0f);
+    }
+    // Friction ellipse: braking or driving hard leaves less grip for cornering.
+    // Apart, since sqrt may set errno and would keep the loop above scalar.
+    for (int i = 0; i < TIRE_COUNT; ++i) {
+        float scale = 1.0f / std::sqrt(usage[i]);
+        batch.fx[i] *= scale;
+        batch.fy[i] *= scale;
+    }
+}
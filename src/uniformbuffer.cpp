@@ -0,0 +1,8 @@
+#include "uniformbuffer.h"
+#include <cstring>
+
+GLuint uniformBlockBinding(const char* blockName) {
+    if (std::strcmp(blockName, "FrameData") == 0) return FRAME_DATA_BINDING;
+    if (std::strcmp(blockName, "BatchDraws") == 0) return BATCH_DRAWS_BINDING;
+    return GL_INVALID_INDEX;
+}
@@ -1,4 +1,5 @@
 #include "utils.h"
+#include <algorithm>
 
 void printMat4(const glm::mat4& mat) {
     for (int i = 0; i < 4; ++i) {
@@ -7,4 +8,34 @@ void printMat4(const glm::mat4& mat) {
         }
         std::cout << std::endl;
     }
-}
\ No newline at end of file
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+uint64_t hashBytes(const std::string& bytes, uint64_t hash) {
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+double median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+void printFrameTimeSummary(const std::string& label, std::vector<double> frameMs) {
+    if (frameMs.empty()) return;
+    std::sort(frameMs.begin(), frameMs.end());
+    double total = 0.0;
+    for (double ms : frameMs) total += ms;
+    double mean = total / frameMs.size();
+    std::cout << label << ": " << frameMs.size() << " frames, mean " << mean << " ms ("
+              << 1000.0 / mean << " fps), median " << frameMs[frameMs.size() / 2]
+              << " ms, p95 " << frameMs[frameMs.size() * 95 / 100]
+              << " ms, worst " << frameMs.back() << " ms" << std::endl;
+}
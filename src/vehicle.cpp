@@ -0,0 +1,211 @@
+#include "vehicle.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <algorithm>
+
+glm::mat4 VehicleState::modelMatrix() const {
+    glm::mat4 model = glm::rotate(glm::mat4(1.0f), heading, glm::vec3(0.0f, 1.0f, 0.0f));
+    model[3] = glm::vec4(position, 1.0f);
+    return model;
+}
+
+float VehicleState::speed() const {
+    return glm::length(velocity);
+}
+
+int VehicleState::rpm() const {
+    return static_cast<int>(speed() * 20);
+}
+
+namespace {
+
+const float GRAVITY = 9.81f;
+const float AIR_DENSITY = 1.225f;
+// Slip is measured against at least this speed, which keeps the tire forces
+// (and the explicit integration) tame when the car is nearly stopped
+const float SLIP_MIN_SPEED = 3.0f;
+
+void steer(VehicleState& state, const VehicleControls& controls, const VehicleParams& params, float dt) {
+    // Holding a key turns the wheels further; they stay where they are when released
+    if (controls.left || controls.right) {
+        float step = (controls.left ? params.steeringRate : -params.steeringRate) * dt;
+        state.steering = glm::clamp(state.steering + step, -params.maxSteeringAngle, params.maxSteeringAngle);
+    }
+}
+
+void stepKinematic(VehicleState& state, const VehicleControls& controls, const VehicleParams& params, float dt) {
+    glm::vec3 forward(std::cos(state.heading), 0.0f, -std::sin(state.heading));
+    glm::vec3 acceleration = state.acceleration;
+
+    if (controls.throttle) {
+        acceleration += forward * params.throttleForce;
+    }
+    float speed = glm::length(state.velocity);
+    if (speed > 0.0f) {
+        glm::vec3 backwards = -state.velocity / speed;
+        if (controls.brake) {
+            acceleration += backwards * params.brakeForce;
+        }
+        // Velocity-dependent drag
+        acceleration += backwards * params.dragCoefficient * speed;
+    }
+    steer(state, controls, params, dt);
+
+    // Euler integration, then the kinematic bicycle model turns the car and its velocity
+    state.velocity += acceleration * dt;
+    speed = glm::length(state.velocity);
+    state.yawRate = std::tan(glm::radians(state.steering)) * speed / params.wheelbase;
+    state.heading += state.yawRate * dt;
+    speed = std::min(speed, params.maxSpeed);
+    state.velocity = glm::vec3(std::cos(state.heading), 0.0f, -std::sin(state.heading)) * speed;
+
+    state.position += state.velocity * dt;
+    state.acceleration = glm::vec3(0.0f);
+    state.wheelSpin += speed / params.wheelRadius * dt;
+}
+
+void stepTire(VehicleState& state, const VehicleControls& controls, const VehicleParams& params, float dt) {
+    // Body frame: x forward, y to the left
+    glm::vec3 forward(std::cos(state.heading), 0.0f, -std::sin(state.heading));
+    glm::vec3 left(-std::sin(state.heading), 0.0f, -std::cos(state.heading));
+    float vx = glm::dot(state.velocity, forward);
+    float vy = glm::dot(state.velocity, left);
+    float r = state.yawRate;
+    steer(state, controls, params, dt);
+    float delta = glm::radians(state.steering);
+
+    const float toFront = params.wheelbase * (1.0f - params.frontWeight);
+    const float toRear = params.wheelbase * params.frontWeight;
+    const float halfTrack = params.trackWidth * 0.5f;
+    const float wheelX[TIRE_COUNT] = { toFront, toFront, -toRear, -toRear };
+    const float wheelY[TIRE_COUNT] = { halfTrack, -halfTrack, halfTrack, -halfTrack };
+    const float wheelSteer[TIRE_COUNT] = { delta, delta, 0.0f, 0.0f };
+
+    // Wheel loads: weight and downforce per axle, then transfer from last step's acceleration
+    float dynamicPressure = 0.5f * AIR_DENSITY * (vx * vx + vy * vy);
+    float weight = params.mass * GRAVITY;
+    float downforce = dynamicPressure * params.downforceArea;
+    float frontAxle = weight * params.frontWeight + downforce * params.aeroBalance;
+    float rearAxle = weight * (1.0f - params.frontWeight) + downforce * (1.0f - params.aeroBalance);
+    float pitch = params.mass * state.bodyAcceleration.x * params.cgHeight / params.wheelbase;
+    float roll = params.mass * state.bodyAcceleration.y * params.cgHeight / params.trackWidth;
+    frontAxle -= pitch;
+    rearAxle += pitch;
+    // Roll is shared between the axles like the weight; cornering left loads the right wheels
+    float frontRoll = roll * params.frontWeight, rearRoll = roll * (1.0f - params.frontWeight);
+
+    TireBatch batch;
+    batch.load[TIRE_FRONT_LEFT] = 0.5f * frontAxle - frontRoll;
+    batch.load[TIRE_FRONT_RIGHT] = 0.5f * frontAxle + frontRoll;
+    batch.load[TIRE_REAR_LEFT] = 0.5f * rearAxle - rearRoll;
+    batch.load[TIRE_REAR_RIGHT] = 0.5f * rearAxle + rearRoll;
+
+    float slipSpeed[TIRE_COUNT];
+    float along[TIRE_COUNT];
+    for (int i = 0; i < TIRE_COUNT; ++i) {
+        // Contact patch velocity in the wheel's own frame
+        float wx = vx - r * wheelY[i];
+        float wy = vy + r * wheelX[i];
+        float c = std::cos(wheelSteer[i]), s = std::sin(wheelSteer[i]);
+        along[i] = wx * c + wy * s;
+        float across = -wx * s + wy * c;
+        slipSpeed[i] = std::max(std::fabs(along[i]), SLIP_MIN_SPEED);
+        batch.slipRatio[i] = (state.wheelSpeed[i] * params.tires[i].radius - along[i]) / slipSpeed[i];
+        batch.slipAngle[i] = -std::atan(across / slipSpeed[i]); // positive pushes the wheel to its left
+    }
+
+    TireSet tires;
+    for (int i = 0; i < TIRE_COUNT; ++i) {
+        tires.set(i, params.tires[i]);
+    }
+    evaluateTires(tires, batch);
+
+    // Tire forces on the body
+    float fx = 0.0f, fy = 0.0f, yawMoment = 0.0f;
+    for (int i = 0; i < TIRE_COUNT; ++i) {
+        float c = std::cos(wheelSteer[i]), s = std::sin(wheelSteer[i]);
+        float bx = batch.fx[i] * c - batch.fy[i] * s;
+        float by = batch.fx[i] * s + batch.fy[i] * c;
+        fx += bx;
+        fy += by;
+        yawMoment += wheelX[i] * by - wheelY[i] * bx;
+    }
+    float speed = std::sqrt(vx * vx + vy * vy);
+    fx -= params.dragArea * 0.5f * AIR_DENSITY * speed * vx;
+    fy -= params.dragArea * 0.5f * AIR_DENSITY * speed * vy;
+    fx -= params.rollingResistance * weight * glm::clamp(vx, -1.0f, 1.0f);
+
+    float ax = fx / params.mass + glm::dot(state.acceleration, forward);
+    float ay = fy / params.mass + glm::dot(state.acceleration, left);
+    state.bodyAcceleration = glm::vec2(ax, ay);
+
+    // Semi-implicit Euler in the rotating body frame
+    vx += (ax + r * vy) * dt;
+    vy += (ay - r * vx) * dt;
+    state.yawRate += yawMoment / params.yawInertia * dt;
+    state.heading += state.yawRate * dt;
+    speed = std::sqrt(vx * vx + vy * vy);
+    if (speed > params.maxSpeed) {
+        vx *= params.maxSpeed / speed;
+        vy *= params.maxSpeed / speed;
+    }
+    forward = glm::vec3(std::cos(state.heading), 0.0f, -std::sin(state.heading));
+    left = glm::vec3(-std::sin(state.heading), 0.0f, -std::cos(state.heading));
+    state.velocity = forward * vx + left * vy;
+    state.position += state.velocity * dt;
+    state.acceleration = glm::vec3(0.0f);
+
+    // Wheel spin. The slip stiffness makes this stiff at low speed, so the tire's
+    // reaction is linearized and taken implicitly, around the slip against the
+    // body's new contact patch speed: linearizing at the old one leaves the wheel
+    // trailing the body's acceleration and the drive force short by dt*k/S*a.
+    float rearSurfaceSpeed = 0.5f * (state.wheelSpeed[TIRE_REAR_LEFT] * params.tires[TIRE_REAR_LEFT].radius +
+                                     state.wheelSpeed[TIRE_REAR_RIGHT] * params.tires[TIRE_REAR_RIGHT].radius);
+    float driveForce = 0.0f;
+    if (controls.throttle) {
+        driveForce = std::min(params.maxDriveForce, params.enginePower / std::max(rearSurfaceSpeed, 1.0f));
+    }
+    for (int i = 0; i < TIRE_COUNT; ++i) {
+        const TireParams& tire = params.tires[i];
+        bool front = i < TIRE_REAR_LEFT;
+        float driveTorque = front ? 0.0f : 0.5f * driveForce * tire.radius;
+        float brakeShare = front ? 0.5f * params.brakeBias : 0.5f * (1.0f - params.brakeBias);
+        float brakeTorque = controls.brake ? params.maxBrakeForce * brakeShare * tire.radius : 0.0f;
+
+        float c = std::cos(wheelSteer[i]), s = std::sin(wheelSteer[i]);
+        float newAlong = (vx - state.yawRate * wheelY[i]) * c + (vy + state.yawRate * wheelX[i]) * s;
+        float reaction = batch.fx[i] - batch.stiffness[i] * (newAlong - along[i]) / slipSpeed[i];
+
+        float damping = 1.0f + dt * batch.stiffness[i] * tire.radius * tire.radius / (tire.inertia * slipSpeed[i]);
+        float& omega = state.wheelSpeed[i];
+        omega += dt / tire.inertia * (driveTorque - tire.radius * reaction) / damping;
+        // Brakes stop the wheel but never turn it backwards
+        float braked = std::max(std::fabs(omega) - dt * brakeTorque / (tire.inertia * damping), 0.0f);
+        omega = std::copysign(braked, omega);
+    }
+
+    rearSurfaceSpeed = 0.5f * (state.wheelSpeed[TIRE_REAR_LEFT] * params.tires[TIRE_REAR_LEFT].radius +
+                               state.wheelSpeed[TIRE_REAR_RIGHT] * params.tires[TIRE_REAR_RIGHT].radius);
+    state.wheelSpin += rearSurfaceSpeed / params.wheelRadius * dt;
+}
+
+} // namespace
+
+void stepVehicle(VehicleState& state, const VehicleControls& controls, const VehicleParams& params, float dt) {
+    if (params.model == VehicleModel::Kinematic) {
+        stepKinematic(state, controls, params, dt);
+    } else {
+        stepTire(state, controls, params, dt);
+    }
+}
+
+VehicleState interpolate(const VehicleState& a, const VehicleState& b, float t) {
+    VehicleState state = b;
+    state.position = glm::mix(a.position, b.position, t);
+    state.velocity = glm::mix(a.velocity, b.velocity, t);
+    state.heading = a.heading + (b.heading - a.heading) * t;
+    state.yawRate = a.yawRate + (b.yawRate - a.yawRate) * t;
+    state.steering = a.steering + (b.steering - a.steering) * t;
+    state.wheelSpin = a.wheelSpin + (b.wheelSpin - a.wheelSpin) * t;
+    return state;
+}
@@ -0,0 +1,225 @@
+#include "vehiclebatch.h"
+#include <cmath>
+#include <algorithm>
+
+// The kernel uses FMA too; MSVC has it with /arch:AVX2 but doesn't define __FMA__
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+#define F1_VEHICLE_AVX2 1
+#endif
+
+VehicleBatch::VehicleBatch(const VehicleParams& params) : params(params), count(0) {}
+
+size_t VehicleBatch::add(const VehicleState& state) {
+    size_t car = count++;
+    if (car % VEHICLE_BATCH_LANES == 0) {
+        // Grow by a whole group of lanes so the kernel never reads past the end
+        size_t padded = car + VEHICLE_BATCH_LANES;
+        for (std::vector<float>* array : { &posX, &posY, &posZ, &velX, &velY, &velZ, &heading, &yawRate,
+                                            &steering, &wheelSpin, &throttle, &brake, &steer }) {
+            array->resize(padded, 0.0f);
+        }
+    }
+    posX[car] = state.position.x;
+    posY[car] = state.position.y;
+    posZ[car] = state.position.z;
+    velX[car] = state.velocity.x;
+    velY[car] = state.velocity.y;
+    velZ[car] = state.velocity.z;
+    heading[car] = state.heading;
+    yawRate[car] = state.yawRate;
+    steering[car] = state.steering;
+    wheelSpin[car] = state.wheelSpin;
+    setControls(car, VehicleControls());
+    return car;
+}
+
+void VehicleBatch::clear() {
+    count = 0;
+    for (std::vector<float>* array : { &posX, &posY, &posZ, &velX, &velY, &velZ, &heading, &yawRate,
+                                        &steering, &wheelSpin, &throttle, &brake, &steer }) {
+        array->clear();
+    }
+}
+
+void VehicleBatch::setControls(size_t car, const VehicleControls& controls) {
+    throttle[car] = controls.throttle ? 1.0f : 0.0f;
+    brake[car] = controls.brake ? 1.0f : 0.0f;
+    // Left wins when both are held, as in stepVehicle
+    steer[car] = controls.left ? 1.0f : (controls.right ? -1.0f : 0.0f);
+}
+
+VehicleState VehicleBatch::state(size_t car) const {
+    VehicleState state;
+    state.position = glm::vec3(posX[car], posY[car], posZ[car]);
+    state.velocity = glm::vec3(velX[car], velY[car], velZ[car]);
+    state.heading = heading[car];
+    state.yawRate = yawRate[car];
+    state.steering = steering[car];
+    state.wheelSpin = wheelSpin[car];
+    return state;
+}
+
+void VehicleBatch::step(float dt) {
+    size_t done = stepAVX2(dt);
+    stepScalar(done, count, dt);
+}
+
+void VehicleBatch::stepScalar(size_t begin, size_t end, float dt) {
+    const float steeringStep = params.steeringRate * dt;
+    for (size_t i = begin; i < end; ++i) {
+        float forwardX = std::cos(heading[i]), forwardZ = -std::sin(heading[i]);
+        float ax = throttle[i] * params.throttleForce * forwardX;
+        float ay = 0.0f;
+        float az = throttle[i] * params.throttleForce * forwardZ;
+
+        // Brake and velocity-dependent drag act against the velocity
+        float speed = std::sqrt(velX[i] * velX[i] + velY[i] * velY[i] + velZ[i] * velZ[i]);
+        if (speed > 0.0f) {
+            float resist = (brake[i] * params.brakeForce + params.dragCoefficient * speed) / speed;
+            ax -= velX[i] * resist;
+            ay -= velY[i] * resist;
+            az -= velZ[i] * resist;
+        }
+        steering[i] = std::clamp(steering[i] + steer[i] * steeringStep, -params.maxSteeringAngle, params.maxSteeringAngle);
+
+        velX[i] += ax * dt;
+        velY[i] += ay * dt;
+        velZ[i] += az * dt;
+        speed = std::sqrt(velX[i] * velX[i] + velY[i] * velY[i] + velZ[i] * velZ[i]);
+        yawRate[i] = std::tan(glm::radians(steering[i])) * speed / params.wheelbase;
+        heading[i] += yawRate[i] * dt;
+        speed = std::min(speed, params.maxSpeed);
+        velX[i] = std::cos(heading[i]) * speed;
+        velY[i] = 0.0f;
+        velZ[i] = -std::sin(heading[i]) * speed;
+
+        posX[i] += velX[i] * dt;
+        posY[i] += velY[i] * dt;
+        posZ[i] += velZ[i] * dt;
+        wheelSpin[i] += speed / params.wheelRadius * dt;
+    }
+}
+
+#ifdef F1_VEHICLE_AVX2
+
+namespace {
+
+// sin and cos of eight angles (Cephes single precision: reduce to [-pi/4, pi/4]
+// by multiples of pi/4, then pick the sine or cosine polynomial per octant)
+inline void sincos8(__m256 x, __m256& sine, __m256& cosine) {
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 sineSign = _mm256_and_ps(x, signMask);
+    x = _mm256_andnot_ps(signMask, x);
+
+    __m256i octant = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(1.27323954473516f))); // 4/pi
+    octant = _mm256_and_si256(_mm256_add_epi32(octant, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+    __m256 y = _mm256_cvtepi32_ps(octant);
+
+    __m256 sineSwap = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(octant, _mm256_set1_epi32(4)), 29));
+    __m256 cosineSign = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_andnot_si256(_mm256_sub_epi32(octant, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+    __m256 sinePoly = _mm256_castsi256_ps(
+        _mm256_cmpeq_epi32(_mm256_and_si256(octant, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+
+    // x - y * pi/4 in three parts to keep the precision of large angles
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(0.78515625f), x);
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(2.4187564849853515625e-4f), x);
+    x = _mm256_fnmadd_ps(y, _mm256_set1_ps(3.77489497744594108e-8f), x);
+    __m256 z = _mm256_mul_ps(x, x);
+
+    __m256 c = _mm256_fmadd_ps(_mm256_set1_ps(2.443315711809948e-5f), z, _mm256_set1_ps(-1.388731625493765e-3f));
+    c = _mm256_fmadd_ps(c, z, _mm256_set1_ps(4.166664568298827e-2f));
+    c = _mm256_mul_ps(_mm256_mul_ps(c, z), z);
+    c = _mm256_add_ps(_mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, c), _mm256_set1_ps(1.0f));
+
+    __m256 s = _mm256_fmadd_ps(_mm256_set1_ps(-1.9515295891e-4f), z, _mm256_set1_ps(8.3321608736e-3f));
+    s = _mm256_fmadd_ps(s, z, _mm256_set1_ps(-1.6666654611e-1f));
+    s = _mm256_fmadd_ps(_mm256_mul_ps(s, z), x, x);
+
+    sine = _mm256_xor_ps(_mm256_blendv_ps(c, s, sinePoly), _mm256_xor_ps(sineSign, sineSwap));
+    cosine = _mm256_xor_ps(_mm256_blendv_ps(s, c, sinePoly), cosineSign);
+}
+
+} // namespace
+
+size_t VehicleBatch::stepAVX2(float dt) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 timeStep = _mm256_set1_ps(dt);
+    const __m256 throttleForce = _mm256_set1_ps(params.throttleForce);
+    const __m256 brakeForce = _mm256_set1_ps(params.brakeForce);
+    const __m256 drag = _mm256_set1_ps(params.dragCoefficient);
+    const __m256 steeringStep = _mm256_set1_ps(params.steeringRate * dt);
+    const __m256 maxSteering = _mm256_set1_ps(params.maxSteeringAngle);
+    const __m256 toRadians = _mm256_set1_ps(glm::radians(1.0f));
+    const __m256 inverseWheelbase = _mm256_set1_ps(1.0f / params.wheelbase);
+    const __m256 maxSpeed = _mm256_set1_ps(params.maxSpeed);
+    const __m256 spinPerMetre = _mm256_set1_ps(1.0f / params.wheelRadius);
+
+    // Padding lanes are stepped too (they hold zeros and stay finite)
+    size_t end = (count + VEHICLE_BATCH_LANES - 1) / VEHICLE_BATCH_LANES * VEHICLE_BATCH_LANES;
+    for (size_t i = 0; i < end; i += VEHICLE_BATCH_LANES) {
+        __m256 h = _mm256_loadu_ps(&heading[i]);
+        __m256 sine, cosine;
+        sincos8(h, sine, cosine);
+        __m256 push = _mm256_mul_ps(_mm256_loadu_ps(&throttle[i]), throttleForce);
+        __m256 ax = _mm256_mul_ps(push, cosine);
+        __m256 az = _mm256_mul_ps(push, _mm256_sub_ps(zero, sine));
+
+        __m256 vx = _mm256_loadu_ps(&velX[i]), vy = _mm256_loadu_ps(&velY[i]), vz = _mm256_loadu_ps(&velZ[i]);
+        __m256 speed = _mm256_sqrt_ps(_mm256_fmadd_ps(vx, vx, _mm256_fmadd_ps(vy, vy, _mm256_mul_ps(vz, vz))));
+        // (brake + drag * speed) / speed, zero for a car at rest
+        __m256 resist = _mm256_fmadd_ps(_mm256_loadu_ps(&brake[i]), brakeForce, _mm256_mul_ps(drag, speed));
+        resist = _mm256_and_ps(_mm256_div_ps(resist, speed), _mm256_cmp_ps(speed, zero, _CMP_GT_OQ));
+        ax = _mm256_fnmadd_ps(vx, resist, ax);
+        __m256 ay = _mm256_mul_ps(vy, _mm256_sub_ps(zero, resist));
+        az = _mm256_fnmadd_ps(vz, resist, az);
+
+        __m256 angle = _mm256_fmadd_ps(_mm256_loadu_ps(&steer[i]), steeringStep, _mm256_loadu_ps(&steering[i]));
+        angle = _mm256_min_ps(_mm256_max_ps(angle, _mm256_sub_ps(zero, maxSteering)), maxSteering);
+        _mm256_storeu_ps(&steering[i], angle);
+
+        vx = _mm256_fmadd_ps(ax, timeStep, vx);
+        vy = _mm256_fmadd_ps(ay, timeStep, vy);
+        vz = _mm256_fmadd_ps(az, timeStep, vz);
+        speed = _mm256_sqrt_ps(_mm256_fmadd_ps(vx, vx, _mm256_fmadd_ps(vy, vy, _mm256_mul_ps(vz, vz))));
+
+        // Bicycle model: yaw rate = tan(steering) * speed / wheelbase
+        __m256 steerSine, steerCosine;
+        sincos8(_mm256_mul_ps(angle, toRadians), steerSine, steerCosine);
+        __m256 yaw = _mm256_mul_ps(_mm256_div_ps(steerSine, steerCosine), _mm256_mul_ps(speed, inverseWheelbase));
+        _mm256_storeu_ps(&yawRate[i], yaw);
+        h = _mm256_fmadd_ps(yaw, timeStep, h);
+        _mm256_storeu_ps(&heading[i], h);
+
+        speed = _mm256_min_ps(speed, maxSpeed);
+        sincos8(h, sine, cosine);
+        vx = _mm256_mul_ps(cosine, speed);
+        vz = _mm256_mul_ps(_mm256_sub_ps(zero, sine), speed);
+        _mm256_storeu_ps(&velX[i], vx);
+        _mm256_storeu_ps(&velY[i], zero);
+        _mm256_storeu_ps(&velZ[i], vz);
+
+        _mm256_storeu_ps(&posX[i], _mm256_fmadd_ps(vx, timeStep, _mm256_loadu_ps(&posX[i])));
+        _mm256_storeu_ps(&posZ[i], _mm256_fmadd_ps(vz, timeStep, _mm256_loadu_ps(&posZ[i])));
+        _mm256_storeu_ps(&wheelSpin[i], _mm256_fmadd_ps(_mm256_mul_ps(speed, spinPerMetre), timeStep,
+                                                        _mm256_loadu_ps(&wheelSpin[i])));
+    }
+    return count;
+}
+
+bool VehicleBatch::vectorized() {
+    return true;
+}
+
+#else
+
+size_t VehicleBatch::stepAVX2(float) {
+    return 0;
+}
+
+bool VehicleBatch::vectorized() {
+    return false;
+}
+
+#endif
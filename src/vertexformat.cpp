@@ -0,0 +1,46 @@
+#include "vertexformat.h"
+#include <GL/glew.h>
+#include <cstddef>
+#include <glm/gtc/packing.hpp>
+
+namespace {
+
+uint16_t quantizeUnorm16(float value) {
+    return static_cast<uint16_t>(glm::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+} // namespace
+
+std::vector<PackedVertex> packVertices(const MeshData& data, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+    glm::vec3 extent = boundsMax - boundsMin;
+    glm::vec3 invExtent(extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+                        extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+                        extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+
+    std::vector<PackedVertex> packed(data.vertices.size());
+    for (size_t i = 0; i < packed.size(); ++i) {
+        glm::vec3 p = (data.vertices[i] - boundsMin) * invExtent;
+        packed[i].position[0] = quantizeUnorm16(p.x);
+        packed[i].position[1] = quantizeUnorm16(p.y);
+        packed[i].position[2] = quantizeUnorm16(p.z);
+        packed[i].position[3] = 0;
+
+        glm::vec3 n = data.normals[i];
+        float length = glm::length(n);
+        if (length > 0.0f) n /= length;
+        packed[i].normal = glm::packSnorm3x10_1x2(glm::vec4(n, 0.0f));
+
+        packed[i].uv[0] = glm::packHalf1x16(data.uvs[i].x);
+        packed[i].uv[1] = glm::packHalf1x16(data.uvs[i].y);
+    }
+    return packed;
+}
+
+void setPackedVertexAttributes() {
+    glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, uv));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+    glEnableVertexAttribArray(2);
+}